@@ -0,0 +1,153 @@
+// ================== ds1307_model.c ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// Virtual DS1307 real-time clock on the simulated IC bus (address 0x68).
+// ----------------------------------------------------------
+// Register file (64 bytes, pointer auto-increments and wraps 0x3F -> 0x00):
+//   0x00 Seconds (bit7 = CH, clock halt)   0x04 Date   (01-31)
+//   0x01 Minutes                            0x05 Month  (01-12)
+//   0x02 Hours (bit6 = 12h mode, bit5 PM)   0x06 Year   (00-99)
+//   0x03 Day (1-7)                          0x07 Control (OUT, SQWE, RS1:0)
+//   0x08-0x3F 56 bytes battery-backed NVRAM
+// Behaviour modelled:
+//   - Power-on: CH = 1 (oscillator stopped), time 00:00:00 01/01/00, NVRAM cleared.
+//   - The clock runs from simCycles while CH = 0 (one second = SIM_SYSCLK cycles).
+//   - Writing the seconds register restarts the 1 Hz divider.
+//   - Time registers are latched into a user buffer when the device is addressed,
+//     so a multi-byte read never sees a rollover in the middle.
+//   - A 1-byte write only sets the pointer (used before a read).
+#include "sim_bus.h"
+
+#define DS1307_ADDR     0x68
+#define DS1307_SECOND   SIM_SYSCLK              // Cycles per second
+
+static U8 bcdInc(U8 v)
+{
+    return ((v & 0x0F) == 9) ? (U8)((v & 0xF0) + 0x10) : (U8)(v + 1);
+}
+
+static U8 daysInMonth(U8 monthBcd, U8 yearBcd)
+{
+    static const U8 days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    U8 month = (U8)((monthBcd >> 4) * 10 + (monthBcd & 0x0F));
+    U8 year  = (U8)((yearBcd >> 4) * 10 + (yearBcd & 0x0F));
+    if (month < 1 || month > 12) return 31;
+    if (month == 2 && (year & 3) == 0) return 29;   // 2000-2099: every 4th year
+    return days[month - 1];
+}
+
+// tickSecond(): Advances the BCD time/date registers by one second.
+static void tickSecond(U8 *r)
+{
+    U8 date;
+    r[0] = bcdInc(r[0] & 0x7F);
+    if (r[0] < 0x60) return;
+    r[0] = 0;
+    r[1] = bcdInc(r[1] & 0x7F);
+    if (r[1] < 0x60) return;
+    r[1] = 0;
+    if (r[2] & 0x40)                            // 12-hour mode: 12 -> 1, 11 -> 12 toggles AM/PM
+    {
+        U8 h = r[2] & 0x1F, pm = r[2] & 0x20;
+        if (h == 0x12) { r[2] = (U8)(0x40 | pm | 0x01); return; }
+        h = bcdInc(h);
+        if (h == 0x12) pm ^= 0x20;
+        r[2] = (U8)(0x40 | pm | h);
+        if (h != 0x12 || pm) return;            // New day at 12 AM
+    }
+    else
+    {
+        r[2] = bcdInc(r[2] & 0x3F);
+        if (r[2] < 0x24) return;
+        r[2] = 0;
+    }
+    r[3] = (r[3] >= 7) ? 1 : (U8)(r[3] + 1);    // Day of week 1..7
+    date = bcdInc(r[4]);
+    if ((U8)((date >> 4) * 10 + (date & 0x0F)) <= daysInMonth(r[5], r[6]))
+    {
+        r[4] = date;
+        return;
+    }
+    r[4] = 0x01;
+    r[5] = bcdInc(r[5]);
+    if (r[5] <= 0x12) return;
+    r[5] = 0x01;
+    r[6] = (r[6] == 0x99) ? 0 : bcdInc(r[6]);
+}
+
+void ds1307Update(Ds1307Model *m)
+{
+    if (m->reg[0] & 0x80)                       // CH set: oscillator stopped
+    {
+        m->lastTick = simCycles;
+        return;
+    }
+    while (simCycles - m->lastTick >= DS1307_SECOND)
+    {
+        m->lastTick += DS1307_SECOND;
+        tickSecond(m->reg);
+    }
+}
+
+// ---------- Bus Callbacks ----------
+static void dsAddressed(SimSlave *s, U8 read)
+{
+    Ds1307Model *m = (Ds1307Model *)s;
+    U8 i;
+    ds1307Update(m);
+    for (i = 0; i < 8; i++) m->shadow[i] = m->reg[i];   // Latch the time for this transfer
+    (void)read;
+}
+
+static U8 dsWrite(SimSlave *s, U8 index, U8 b)
+{
+    Ds1307Model *m = (Ds1307Model *)s;
+    if (index == 0)
+    {
+        m->ptr = b & 0x3F;                      // Register pointer
+        return 0;
+    }
+    if (m->ptr == 0)
+    {
+        ds1307Update(m);                        // Run up to now before the divider restarts
+        m->lastTick = simCycles;
+    }
+    m->reg[m->ptr] = b;
+    m->ptr = (m->ptr + 1) & 0x3F;
+    return 0;
+}
+
+static U8 dsRead(SimSlave *s)
+{
+    Ds1307Model *m = (Ds1307Model *)s;
+    U8 v = (m->ptr < 8) ? m->shadow[m->ptr] : m->reg[m->ptr];
+    m->ptr = (m->ptr + 1) & 0x3F;
+    return v;
+}
+
+static void dsStop(SimSlave *s)
+{
+    (void)s;
+}
+
+// ---------- Public API ----------
+void ds1307Init(Ds1307Model *m)
+{
+    U8 i;
+    m->slave.name = "DS1307";
+    m->slave.addr = DS1307_ADDR;
+    m->slave.standardOnly = 1;                  // 100 kHz part (datasheet: fSCL <= 100 kHz)
+    m->slave.onAddressed = dsAddressed;
+    m->slave.onWrite = dsWrite;
+    m->slave.onRead = dsRead;
+    m->slave.onStop = dsStop;
+    for (i = 0; i < 64; i++) m->reg[i] = 0;
+    m->reg[0] = 0x80;                           // CH = 1 at first power-up
+    m->reg[3] = 0x01;
+    m->reg[4] = 0x01;
+    m->reg[5] = 0x01;
+    m->ptr = 0;
+    m->lastTick = simCycles;
+    simAttach(&m->slave);
+}
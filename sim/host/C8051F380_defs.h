@@ -0,0 +1,35 @@
+// ================== C8051F380_defs.h (host) ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// SFRs and SFR bits used by the firmware headers, as plain variables. The
+// simulation only drives the IC pins; the other registers just have to exist
+// (reads return what the code last wrote). 16-bit SFRs (sfr16) are U16.
+#ifndef C8051F380_DEFS_H
+#define C8051F380_DEFS_H
+
+#include "compiler_defs.h"
+
+// ---------- 8-bit SFRs ----------
+static volatile U8 P0, P1, P2, P3, P4;
+static volatile U8 P0MDOUT, P1MDOUT, P2MDOUT, P0MDIN, P1MDIN, P2MDIN, P0SKIP, P1SKIP, P2SKIP;
+static volatile U8 XBR0, XBR1, XBR2, IT01CF, IE, IP, EIE1, EIE2, EIP1, EIP2, RSTSRC;
+static volatile U8 PCA0MD, PCA0CN, PCA0L, PCA0H;
+static volatile U8 PCA0CPM0, PCA0CPL0, PCA0CPH0, PCA0CPM1, PCA0CPL1, PCA0CPH1;
+static volatile U8 PCA0CPM2, PCA0CPL2, PCA0CPH2, PCA0CPM3, PCA0CPL3, PCA0CPH3;
+static volatile U8 PCA0CPM4, PCA0CPL4, PCA0CPH4;
+static volatile U8 ADC0CN, ADC0CF, AMX0P, AMX0N, REF0CN, ADC0H, ADC0L;
+static volatile U8 ADC0GTH, ADC0GTL, ADC0LTH, ADC0LTL;
+static volatile U8 TMOD, TCON, CKCON, TH0, TL0, TH1, TL1;
+static volatile U8 TMR2CN, TMR2RLL, TMR2RLH, TMR2L, TMR2H;
+static volatile U8 TMR3CN, TMR3RLL, TMR3RLH, TMR3L, TMR3H;
+
+// ---------- 16-bit SFRs ----------
+static volatile U16 ADC0, ADC0GT, ADC0LT, TMR2RL, TMR2, TMR3RL, TMR3, PCA0;
+
+// ---------- SFR bits ----------
+static volatile U8 CY, EA, EX0, EX1, IT0, IT1, IE0, IE1, ET0, ET2, TR0, TR1, TF0, TF1;
+static volatile U8 TR2, TF2H, TF2L, CR, CF, CCF0, CCF1, CCF2, CCF3, CCF4;
+static volatile U8 AD0EN, AD0BUSY, AD0INT, AD0WINT;
+
+#endif
@@ -0,0 +1,29 @@
+// ================== compiler_defs.h (host) ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// Stand-in for the Keil compiler_defs.h so the driver headers compile on Linux:
+//   - Fixed-width U8..S32 with the C51 sizes (int is 16 bit on the target)
+//   - Keil memory/storage keywords compile away, `bit` becomes a byte
+// sbit pins and interrupt functions are excluded with #ifndef SIM_HOST in the
+// firmware headers and replaced by the simulation (sim_bus.h).
+#ifndef COMPILER_DEFS_H
+#define COMPILER_DEFS_H
+
+#include <stdint.h>
+
+typedef uint8_t  U8;
+typedef uint16_t U16;
+typedef uint32_t U32;
+typedef int8_t   S8;
+typedef int16_t  S16;
+typedef int32_t  S32;
+
+#define bit      U8
+#define code
+#define xdata
+#define idata
+#define pdata
+#define reentrant
+
+#endif
@@ -0,0 +1,505 @@
+// ================== i2c_sim.c ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// Runs the unmodified IC driver from my_private_header.h against the virtual
+// LM75/DS1307 models and reports results, protocol/timing violations and the
+// cost of every transaction in SYSCLK cycles.
+// ----------------------------------------------------------
+// Build and run (from the repository root):
+//   gcc -DSIM_HOST -Isim -Isim/host -Isrc/include sim/*.c -lm -o i2c_sim && ./i2c_sim
+//   add -DI2C_FAST_MODE=1 for the 400 kHz timing profile
+// [1] Scenarios: one function per case, each on a freshly reset bus
+// [2] Benchmark: cycles, time and achieved SCL rate per driver call,
+//     LM75 array pass time for 1..8 sensors
+// [3] Sunrise/sunset solver accuracy (solar_ref.c)
+// [4] Trace loop: main-loop passes with the TRACE() stages of trace.h, IC stages and
+//     servo 0 driven by servoStep() at every PCA frame; `./i2c_sim --vcd i2c_sim.vcd`
+//     records the whole run for GTKWave
+// [5] Sampling-policy replay: rain/light traces through per-loop polling and through
+//     policyDue()/policyUpdate(), runProject() decisions compared loop by loop
+// Exit status is non-zero when a scenario fails or reports an unexpected
+// number of violations.
+#include <stdio.h>
+#include <string.h>
+#include "sim_bus.h"
+#include "my_private_header.h"
+#include "sample_policy.h"              // LOOP_MS
+#include "site_config.h"                // SERVO_COUNT, sector table
+U16 calYday = 1;                        // calendar.h stand-in (sectorWater() in servo.h)
+#include "servo.h"                      // servoLutBuild()/servoStep(): the PWM of the trace loop
+
+#define LM75_W  (LM75_ADDR << 1)        // Address bytes as passed to the driver
+#define LM75_R  ((LM75_ADDR << 1) | 1)
+
+static Lm75Model   lm75;
+static Ds1307Model rtc;
+static U8 failures = 0;
+
+U8 solarCheck(void);                    // solar_ref.c
+
+// ---------- Helpers ----------
+static U8 check(U8 ok, const char *what)
+{
+    if (!ok) printf("    -- failed: %s\n", what);
+    return ok;
+}
+
+// rawRtc(): Reads `n` raw DS1307 registers from `reg` (no BCD conversion, CH kept).
+// Standard-mode timing like the driver's DS1307 functions (checked by the bus).
+static U8 rawRtc(U8 reg, U8 *buf, U8 n)
+{
+    U8 i, nack;
+    I2C_SLOW();
+    startI2c();
+    nack = writeByteI2c(0xD0) || writeByteI2c(reg);
+    stopI2c();
+    if (!nack)
+    {
+        startI2c();
+        nack = writeByteI2c(0xD1);
+        for (i = 0; i < n && !nack; i++) buf[i] = readByteI2c(i == n - 1);  // NACK the last byte
+        stopI2c();
+    }
+    I2C_FAST();
+    return nack ? I2C_NACK : i2cResult(0);
+}
+
+// rawRtcWrite(): Writes one raw byte (e.g. seconds with CH set).
+static U8 rawRtcWrite(U8 reg, U8 v)
+{
+    U8 nack;
+    I2C_SLOW();
+    startI2c();
+    nack = writeByteI2c(0xD0) || writeByteI2c(reg) || writeByteI2c(v);
+    stopI2c();
+    I2C_FAST();
+    return i2cResult(nack);
+}
+
+// ---------- [1] Scenarios ----------
+static U8 lm75ReadCase(void)
+{
+    float t = -99;
+    lm75Init(&lm75, LM75_ADDR);
+    lm75SetTemp(&lm75, 204);                                    // 25.5 C
+    return check(readTemp(LM75_R, &t) == I2C_OK, "readTemp status")
+         & check(t == 25.5f, "25.5 C decoded")
+         & check(lm75Dev.retries == 0, "no retries");
+}
+
+// lm75Negative(): Sub-zero readings keep their sign (two's complement register).
+static U8 lm75Negative(void)
+{
+    float t = 99;
+    lm75Init(&lm75, LM75_ADDR);
+    lm75SetTemp(&lm75, -26);                                    // -3.25 C
+    if (!check(readTemp(LM75_R, &t) == I2C_OK && t == -3.25f, "-3.25 C decoded")) return 0;
+    lm75SetTemp(&lm75, -55 * 8);                                // Bottom of the range
+    return check(readTemp(LM75_R, &t) == I2C_OK && t == -55.0f, "-55 C decoded");
+}
+
+static U8 lm75Alarm(void)
+{
+    float t = 0;
+    lm75Init(&lm75, LM75_ADDR);
+    lm75SetTemp(&lm75, 28 * 8);
+    if (!check(setTempAlarm(&lm75Dev, LM75_W, 30) == I2C_OK, "setTempAlarm status")) return 0;
+    return check(lm75.conf == LM75_CONF_COMP, "comparator mode, fault queue 4")
+         & check(lm75.tos == (30 << 8) && lm75.thyst == (29 << 8), "TOS 30 / THYST 29")
+         & check(readTemp(LM75_R, &t) == I2C_OK && t == 28.0f, "pointer parked on temperature")
+         & check((lm75SetTemp(&lm75, 31 * 8), delay_ms(300), LM75_OS == 1), "3 hot conversions: O.S. idle")
+         & check((delay_ms(100), LM75_OS == 0), "4th hot conversion: O.S. active")
+         & check((lm75SetTemp(&lm75, 29 * 8 + 4), delay_ms(1000), LM75_OS == 0), "29.5 C is inside the hysteresis")
+         & check((lm75SetTemp(&lm75, 28 * 8), delay_ms(400), LM75_OS == 1), "28 C releases O.S.");
+}
+
+static U8 rtcClock(void)
+{
+    U8 h = 0, m = 0, s = 0, r[8];
+    ds1307Init(&rtc);
+    if (!check(readDS1307(0x00, &s) == I2C_OK && (rtc.reg[0] & 0x80), "CH set at power-on")) return 0;
+    setupTime(12, 34, 56);                                      // Seconds written last -> CH = 0
+    delay_ms(2000);
+    readDS1307(0x02, &h);
+    readDS1307(0x01, &m);
+    readDS1307(0x00, &s);
+    if (!check(h == 12 && m == 34 && s == 58, "setupTime + 2 s")) return 0;
+    rawRtcWrite(0x00, 0x80 | 0x10);                             // Halt the oscillator at :10
+    delay_ms(3000);
+    readDS1307(0x00, &s);
+    if (!check(s == 10, "CH = 1 stops the clock")) return 0;
+    rawRtcWrite(0x06, 0x24);                                    // 2024 (leap year)
+    rawRtcWrite(0x05, 0x02);
+    rawRtcWrite(0x04, 0x28);
+    rawRtcWrite(0x02, 0x23);
+    rawRtcWrite(0x01, 0x59);
+    rawRtcWrite(0x00, 0x59);                                    // 23:59:59 28/02/24, running
+    delay_ms(1000);
+    return check(rawRtc(0x00, r, 7) == I2C_OK, "burst read 0x00-0x06")
+         & check(r[0] == 0 && r[1] == 0 && r[2] == 0 && r[4] == 0x29 && r[5] == 0x02, "rollover to 29/02 00:00:00");
+}
+
+static U8 rtcNvram(void)
+{
+    U8 v = 0, r[2];
+    ds1307Init(&rtc);
+    rtc.reg[0] = 0x17;                                          // Running, :17
+    return check(writeDS1307(0x08, 42) == I2C_OK, "NVRAM write")
+         & check(readDS1307(0x08, &v) == I2C_OK && v == 42, "NVRAM read back")
+         & check(rtc.reg[0x08] == 0x42, "stored as BCD")
+         & check((rtc.reg[0x3F] = 0xA5, rawRtc(0x3F, r, 2) == I2C_OK), "read across 0x3F")
+         & check(r[0] == 0xA5 && r[1] == 0x17, "pointer wraps 0x3F -> 0x00");
+}
+
+// rtcBurst(): setupCommit()-style write of 0x00-0x06 in one transaction, then read back.
+static U8 rtcBurst(void)
+{
+    U8 w[7] = { 0x00, 0x45, 0x07, 0x04, 0x15, 0x10, 0x25 };    // 07:45:00 Wed 15/10/25
+    U8 r[7] = { 0 };
+    U16 clocks;
+    ds1307Init(&rtc);
+    clocks = simSclClocks;
+    if (!check(writeDS1307Burst(0x00, w, 7) == I2C_OK, "7-byte burst write")) return 0;
+    if (!check(simSclClocks - clocks == 9 * 9 + 1, "one transaction (9 bytes + STOP clock)")) return 0;
+    delay_ms(1000);
+    return check(readDS1307Burst(0x00, r, 7) == I2C_OK, "7-byte burst read")
+         & check(r[0] == 0x01 && r[1] == 0x45 && r[2] == 0x07, "clock started by the burst, +1 s")
+         & check(r[3] == 0x04 && r[4] == 0x15 && r[5] == 0x10 && r[6] == 0x25, "date intact");
+}
+
+static U8 absentDevice(void)
+{
+    float t = 12.5f;
+    return check(readTemp(LM75_R, &t) == I2C_NACK, "NACK reported")
+         & check(lm75Dev.retries == I2C_RETRIES && lm75Dev.errors == 1, "retried, then counted as error")
+         & check(t == 12.5f, "last good value kept");
+}
+
+static U8 busClear(void)
+{
+    float t = 0;
+    lm75Init(&lm75, LM75_ADDR);
+    delay_us(10);
+    simStickSda(5);                                             // Slave stuck mid-byte for 5 clocks
+    return check(readTemp(LM75_R, &t) == I2C_OK && t == 25.0f, "read after recovery")
+         & check(i2cBusClears == 1, "one 9-clock bus clear");
+}
+
+static U8 busStuck(void)
+{
+    float t = 0;
+    lm75Init(&lm75, LM75_ADDR);
+    delay_us(10);
+    simStickSda(200);                                           // Longer than every recovery attempt
+    return check(readTemp(LM75_R, &t) == I2C_BUS_STUCK, "I2C_BUS_STUCK reported")
+         & check(i2cBusClears == I2C_RETRIES + 1, "one bus clear per attempt");
+}
+
+static U8 clockStretch(void)
+{
+    float t = 0;
+    U8 ok;
+    lm75Init(&lm75, LM75_ADDR);
+    simHoldScl(SIM_SYSCLK / 100000);                            // 10 s stretch, within I2C_STRETCH_MAX
+    ok = check(readTemp(LM75_R, &t) == I2C_OK, "short stretch tolerated");
+    simHoldScl(0xFFFFFFFFUL);                                   // Dead slave holding SCL
+    ok &= check(readTemp(LM75_R, &t) == I2C_TIMEOUT, "I2C_TIMEOUT reported");
+    simHoldScl(0);
+    return ok;
+}
+
+static U8 missingNack(void)
+{
+    lm75Init(&lm75, LM75_ADDR);
+    startI2c();
+    writeByteI2c(LM75_R);
+    readByteI2c(0);
+    readByteI2c(0);                                             // Bug under test: last byte ACKed
+    stopI2c();
+    return check(simViolations == 1, "violation reported once");
+}
+
+// Foreign device in the LM75 address range (e.g. an ADC): ACKs everything, reads 0xFF.
+static void foreignAddressed(SimSlave *s, U8 read) { (void)s; (void)read; }
+static U8   foreignWrite(SimSlave *s, U8 index, U8 b) { (void)s; (void)index; (void)b; return 0; }
+static U8   foreignRead(SimSlave *s) { (void)s; return 0xFF; }
+static void foreignStop(SimSlave *s) { (void)s; }
+static SimSlave foreign;
+
+static Lm75Model lm75Set[LM75_MAX];
+
+static U8 lm75Array(void)
+{
+    U8 ok;
+    U16 single;
+    lm75Init(&lm75Set[0], 0x48);
+    lm75Init(&lm75Set[1], 0x4A);
+    lm75Init(&lm75Set[2], 0x4F);
+    foreign.name = "ADC";
+    foreign.addr = 0x4C;
+    foreign.onAddressed = foreignAddressed;
+    foreign.onWrite = foreignWrite;
+    foreign.onRead = foreignRead;
+    foreign.onStop = foreignStop;
+    simAttach(&foreign);
+    lm75SetTemp(&lm75Set[0], 20 * 8);                           // 20.0 C
+    lm75SetTemp(&lm75Set[1], 24 * 8 + 4);                       // 24.5 C
+    lm75SetTemp(&lm75Set[2], -26);                              // -3.25 C
+    ok = check(lm75Scan() == 3, "3 LM75 found, 0x4C skipped")
+       & check(lm75s[0].addr == 0x48 && lm75s[1].addr == 0x4A && lm75s[2].addr == 0x4F, "address order")
+       & check(lm75SampleAll() == 3, "all sensors answer")
+       & check(lm75Min8 == -26 && lm75Max8 == 196 && lm75Avg8 == (160 + 196 - 26) / 3, "min/avg/max")
+       & check(lm75AlarmAll(22) == I2C_OK, "TOS programmed in every sensor")
+       & check((delay_ms(400), LM75_OS == 0), "shared O.S. follows the hottest sensor");
+    simDetach(&lm75Set[1].slave);                               // Unplug the hot one
+    single = lm75Dev.errors;
+    return ok & check(lm75SampleAll() == 2 && lm75Max8 == 160, "missing sensor left out of the aggregate")
+              & check(lm75s[1].dev.errors == 1 && lm75s[1].t8 == 196, "last good value kept")
+              & check(lm75AlarmAll(22) != I2C_OK && lm75s[1].dev.errors == 2 && lm75Dev.errors == single,
+                      "TOS write failure booked on the array entry");
+}
+
+// ---------- [4] Trace Loop ----------
+#define TRACE_PASSES    100                                     // 2 s of main loop (~120 servo frames)
+#define LOOP_CYCLES     ((U32)LOOP_MS * (SIM_SYSCLK / 1000UL))
+
+// pcaFrame(): PCA_ISR stand-in: one SERVO_FRAME() per channel (servo.h).
+static U16 pcaFrame(U8 ch)
+{
+    return ch < SERVO_COUNT ? servoStep(ch) : 0;
+}
+
+/*
+ * traceLoop(): Main-loop passes as the firmware traces them: stages TR_STAGE_FIRST ..
+ * TR_STAGE_LAST in the order of trace.h, then TR_IDLE up to LOOP_MS. The IC stages
+ * run the driver (LM75 batch every 5th pass as the sampling policy would, DS1307
+ * burst every 10th as the drift tracker does), the other stages only set their
+ * codes. Servo 0 sweeps as on the target: servoStep() and the calibrated
+ * compare table of servo.h, called at every PCA overflow.
+ */
+static U8 traceLoop(void)
+{
+    U8 i, tr, regs[7], ok, deg0, turned = 0;
+    U32 pass;
+    for (i = 0; i < 3; i++) lm75Init(&lm75Set[i], LM75_ADDR + i);
+    ds1307Init(&rtc);
+    ok = check(lm75Scan() == 3, "3 LM75 found");
+    servoLutBuild(0);                                           // As servoStart(): table, dwell weights
+    sectorBuild();
+    servoSweepAll(1);                                           // Pump on: every channel sweeps
+    deg0 = servoDeg(0);
+    simPcaFrame(pcaFrame);
+    for (i = 0; i < TRACE_PASSES; i++)
+    {
+        pass = simCycles;
+        for (tr = TR_STAGE_FIRST; tr <= TR_STAGE_LAST; tr++)
+        {
+            TRACE(tr);
+            if (tr == TR_TEMP && i % 5 == 0) ok &= check(lm75SampleAll() == 3, "batch pass");
+            if (tr == TR_CLOCK && i % 10 == 0) ok &= check(readDS1307Burst(0x00, regs, 7) == I2C_OK, "RTC burst");
+        }
+        TRACE(TR_IDLE);
+        if (simCycles - pass < LOOP_CYCLES) simDelayCycles(pass + LOOP_CYCLES - simCycles);
+        if (!servo[0].up) turned = 1;                           // Sweep reached hi and reversed
+    }
+    ok &= check(servoDeg(0) != deg0 && turned, "servo 0 swept to 180 and back");
+    servoSweepAll(0);                                           // Pump off: park
+    simPcaFrame(0);
+    servoCalibrate(0, 700, 2300);                               // Cal screen: trim, hold the end point
+    servoSet(0, 0);
+    servoSweepAll(1);
+    ok &= check(servo[0].mode == SERVO_HOLD, "held channel not swept");
+    servoRelease(0);                                            // Cal screen left
+    ok &= check(servo[0].mode == SERVO_PARK, "released channel parks");
+    servoCal[0].us0 = SERVO_US_0;
+    servoCal[0].us180 = SERVO_US_180;
+    servoCalLoad();                                             // As after a reset
+    ok &= check(servoCal[0].us0 == 700 && servoCal[0].us180 == 2300, "calibration kept in NVRAM");
+    servoCalibrate(0, SERVO_US_0, SERVO_US_180);
+    return ok;
+}
+
+// ---------- [5] Sampling-policy Replay ----------
+// Sensor traces as the ADC reports them (%, one value per main-loop pass), given as
+// keyframes with linear ramps in between plus 1 % of ADC noise. Each trace is
+// replayed twice: polled on every loop (reference) and sampled only when policyDue()
+// says so, holding the last sample in between as main() does. The runProject()
+// input is `value >= threshold` (light too bright / no rain): every loop where the
+// two decisions differ is a loop on which the policy decides late.
+#define REPLAY_KEYS     6
+
+typedef struct
+{
+    const char *name;
+    U8  sensor;                         // SENSOR_RAIN / SENSOR_LIGHT
+    S16 threshold;                      // As main() loads it (RAIN_THRESHOLD 80 / LIGHT_THRESHOLD 70)
+    U16 lateMax;                        // Allowed decision lag in loops (sample_policy.h "Decision equivalence")
+    U16 at[REPLAY_KEYS];                // Keyframe loop (increasing, last = trace length)
+    U8  pct[REPLAY_KEYS];               // Value at the keyframe
+} ReplayTrace;
+
+// Slow traces move less than `band` (10 %) per maxPeriod (100 loops): no lag allowed.
+// The shower and the splash cross the band between two samples of a stable sensor,
+// so the decision may lag by up to maxPeriod - 1 loops.
+static const ReplayTrace replayTraces[] = {
+    { "dawn",     SENSOR_LIGHT, 70, 0,  { 0, 500, 4000, 6000, 9000, 12000 }, { 2, 2,  60,  75,  95,  95 } },
+    { "clouds",   SENSOR_LIGHT, 70, 0,  { 0, 1500, 3000, 4500, 6000, 9000 }, { 90, 62, 78, 55, 85, 85 } },
+    { "drizzle",  SENSOR_RAIN,  80, 0,  { 0, 1000, 5000, 7000, 11000, 12000 }, { 100, 100, 72, 72, 98, 98 } },
+    { "shower",   SENSOR_RAIN,  80, 99, { 0, 3000, 3040, 6000, 6600, 9000 }, { 100, 100, 20, 20, 100, 100 } },
+    { "splash",   SENSOR_RAIN,  80, 99, { 0, 2500, 2501, 2700, 2701, 5000 }, { 100, 100, 30, 30, 100, 100 } },
+};
+
+// replayValue(): Trace value at `loop` (keyframe ramps + deterministic noise).
+static S16 replayValue(const ReplayTrace *tr, U16 loop, U32 *seed)
+{
+    U8 k = 1;
+    S16 v;
+    while (k < REPLAY_KEYS - 1 && loop > tr->at[k]) k++;
+    v = tr->pct[k - 1] + (S16)(((S32)tr->pct[k] - tr->pct[k - 1]) * (S32)(loop - tr->at[k - 1])
+                               / (S32)(tr->at[k] - tr->at[k - 1]));
+    *seed = *seed * 1103515245UL + 12345UL;
+    v += (S16)((*seed >> 16) % 3) - 1;                          // ADC noise: -1, 0, +1 %
+    return v < 0 ? 0 : v > 100 ? 100 : v;
+}
+
+// policyRestart(): Policy record as at boot (first loop samples, nominal period).
+static void policyRestart(U8 sensor, S16 threshold)
+{
+    SamplePolicy xdata *p = &policy[sensor];
+    p->threshold = threshold;
+    p->period = p->basePeriod;
+    p->elapsed = 255;
+    p->last = 0;
+    p->samples = 0;
+    p->periodSum = 0;
+}
+
+/*
+ * policyReplay(): Both sampling schemes over every trace. Reports the worst lag
+ * (consecutive late loops) and the sample count next to per-loop polling.
+ */
+static U8 policyReplay(void)
+{
+    const ReplayTrace *tr;
+    U8 ok = 1, polled, held;
+    U16 loop, late, worst;
+    S16 v, sample;
+    U32 seed;
+    for (tr = replayTraces; tr < replayTraces + sizeof replayTraces / sizeof replayTraces[0]; tr++)
+    {
+        policyRestart(tr->sensor, tr->threshold);
+        seed = tr->threshold;
+        sample = 0;
+        late = worst = 0;
+        for (loop = 0; loop <= tr->at[REPLAY_KEYS - 1]; loop++)
+        {
+            v = replayValue(tr, loop, &seed);
+            if (policyDue(tr->sensor))
+            {
+                sample = v;
+                policyUpdate(tr->sensor, sample);
+            }
+            polled = (v >= tr->threshold);
+            held = (sample >= tr->threshold);
+            late = (polled != held) ? late + 1 : 0;
+            if (late > worst) worst = late;
+        }
+        printf("    %-8s %5u loops, %5u samples, worst lag %2u loops (%4u ms, allowed %u)\n", tr->name,
+               loop, policy[tr->sensor].samples, worst, worst * LOOP_MS, tr->lateMax);
+        ok &= check(worst <= tr->lateMax, tr->name);
+    }
+    return ok;
+}
+
+// ---------- [2] Benchmark ----------
+static void bench(const char *name, U8 which)
+{
+    U32 c0 = simCycles;
+    U16 k0 = simSclClocks;
+    U32 cycles, ns;
+    U16 clocks;
+    float t;
+    U8 v;
+    switch (which)
+    {
+    case 0: readTemp(LM75_R, &t); break;
+    case 1: setTempAlarm(&lm75Dev, LM75_W, 30); break;
+    case 2: readDS1307(0x00, &v); break;
+    case 3: writeDS1307(0x08, 7); break;
+    default: setupTime(8, 0, 0); break;
+    }
+    cycles = simCycles - c0;
+    clocks = (U16)(simSclClocks - k0);
+    ns = SIM_CYCLES_NS(cycles);
+    printf("  %-14s %7lu cyc %8.1f us %4u SCL  %5.1f kHz\n", name, (unsigned long)cycles,
+           ns / 1000.0, clocks, ns ? clocks * 1000000.0 / ns : 0.0);
+}
+
+static void run(const char *name, U8 (*fn)(void), U16 expectViolations)
+{
+    U8 ok;
+    simReset(I2C_FAST_MODE);
+    lm75Reset();
+    lm75Dev.retries = lm75Dev.errors = 0;
+    rtcDev.retries = rtcDev.errors = 0;
+    i2cBusClears = 0;
+    ok = fn();
+    ok &= check(simViolations == expectViolations, "violation count");
+    printf("%s  %-14s violations %u (expected %u)\n", ok ? "PASS" : "FAIL", name, simViolations, expectViolations);
+    if (!ok) failures++;
+}
+
+int main(int argc, char **argv)
+{
+    U8 i, k;
+    if (argc == 3 && !strcmp(argv[1], "--vcd") && !simVcdOpen(argv[2]))
+    {
+        printf("cannot create %s\n", argv[2]);
+        return 2;
+    }
+    printf("I2C host simulation: %lu Hz SCL profile, LOW %u + HIGH %u loops\n",
+           (unsigned long)I2C_SCL_HZ, (unsigned)I2C_LOW_LOOPS, (unsigned)I2C_HIGH_LOOPS);
+    run("lm75-read",     lm75ReadCase,     0);
+    run("lm75-negative", lm75Negative, 0);
+    run("lm75-alarm",    lm75Alarm,    0);
+    run("rtc-clock",     rtcClock,     0);
+    run("rtc-nvram",     rtcNvram,     0);
+    run("rtc-burst",     rtcBurst,     0);
+    run("absent-device", absentDevice, 0);
+    run("bus-clear",     busClear,     1);     // Recovery STOP lands inside the stuck byte
+    run("bus-stuck",     busStuck,     0);
+    run("clock-stretch", clockStretch, 0);
+    run("missing-nack",  missingNack,  1);
+    run("lm75-array",    lm75Array,    0);
+    run("solar-accuracy", solarCheck,  0);
+    run("trace-loop",    traceLoop,    0);
+    run("policy-replay", policyReplay, 0);
+
+    printf("Benchmark (per driver call):\n");
+    simReset(I2C_FAST_MODE);
+    lm75Reset();
+    lm75Init(&lm75, LM75_ADDR);
+    ds1307Init(&rtc);
+    bench("readTemp", 0);
+    bench("setTempAlarm", 1);
+    bench("readDS1307", 2);
+    bench("writeDS1307", 3);
+    bench("setupTime", 4);
+    for (k = 1; k <= LM75_MAX; k++)                             // Batched pass: bus time vs. sensor count
+    {
+        U32 c0;
+        simReset(I2C_FAST_MODE);
+        lm75Reset();
+        for (i = 0; i < k; i++) lm75Init(&lm75Set[i], LM75_ADDR + i);
+        lm75Scan();
+        c0 = simCycles;
+        lm75SampleAll();
+        printf("  lm75SampleAll n=%u %6lu cyc %7.1f us (%lu cyc/sensor)\n", k, (unsigned long)(simCycles - c0),
+               SIM_CYCLES_NS(simCycles - c0) / 1000.0, (unsigned long)((simCycles - c0) / k));
+    }
+    if (simViolations) failures++;
+    simVcdClose();
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+// ================== lm75_model.c ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// Virtual LM75 temperature sensor on the simulated IC bus.
+// ----------------------------------------------------------
+// Registers (pointer = first byte written after the address):
+//   0x00 Temp  (read-only, 16 bit, MSB first, 11-bit value in 1/8 C left-aligned)
+//   0x01 Conf  (8 bit: bit0 shutdown, bit1 interrupt mode, bit2 O.S. polarity, bits4:3 fault queue)
+//   0x02 THYST (16 bit, 9-bit value, bit 7 of the LSB = 0.5 C), power-on 75 C
+//   0x03 TOS   (16 bit, same format),                              power-on 80 C
+// Reads start at the pointer and repeat the same register (the pointer does not
+// auto-increment); a write of 1 byte only moves the pointer.
+// O.S. comparator: a conversion runs every 100 ms of simulated time; after
+// `fault queue` consecutive conversions with T >= TOS the output goes active, after
+// the same number with T < THYST it is released. Interrupt mode (conf bit1) is
+// modelled as comparator mode; the firmware only uses comparator mode.
+#include "sim_bus.h"
+
+#define LM75_CONV_CYCLES (SIM_SYSCLK / 10)     // One conversion every 100 ms
+#define LM75_MAX_DEVS    8                      // Addresses 0x48..0x4F share one O.S. line
+
+static Lm75Model *devs[LM75_MAX_DEVS];
+static U8 devCount = 0;
+
+// half(): 16-bit TOS/THYST image -> 9-bit comparator value in 1/2 C.
+static S16 half(S16 reg16)
+{
+    return (S16)(reg16 >> 7);
+}
+
+// lm75Convert(): Runs the conversions that happened since the last call.
+static void lm75Convert(Lm75Model *m)
+{
+    static const U8 queue[4] = { 1, 2, 4, 6 };
+    U32 n = (simCycles - m->lastConv) / LM75_CONV_CYCLES;
+    U8 depth = queue[(m->conf >> 3) & 3];
+    U8 active = (m->conf & 0x04) ? 1 : 0;       // O.S. level when asserted (polarity bit)
+    S16 t2 = (S16)(m->temp8 >> 2);               // 1/2 C, as compared by the device
+    if (n == 0 || (m->conf & 0x01)) return;      // No new conversion / shut down
+    m->lastConv += n * LM75_CONV_CYCLES;
+    if (n > depth) n = depth;                    // Enough to fill the fault queue
+    while (n--)
+    {
+        U8 asserted = (m->os == active);
+        U8 out = asserted ? (t2 < half(m->thyst)) : (t2 >= half(m->tos));
+        m->faults = out ? m->faults + 1 : 0;
+        if (m->faults >= depth)
+        {
+            m->os = asserted ? !active : active;
+            m->faults = 0;
+        }
+    }
+}
+
+// ---------- Bus Callbacks ----------
+static void lm75Addressed(SimSlave *s, U8 read)
+{
+    Lm75Model *m = (Lm75Model *)s;
+    lm75Convert(m);
+    m->byteSel = 0;
+    (void)read;
+}
+
+static U8 lm75Write(SimSlave *s, U8 index, U8 b)
+{
+    Lm75Model *m = (Lm75Model *)s;
+    if (index == 0)
+    {
+        if (b > 3) return 1;                    // Only pointers 0..3 exist
+        m->ptr = b;
+        return 0;
+    }
+    switch (m->ptr)
+    {
+    case 1:
+        if (index != 1) return 1;               // Conf is one byte
+        m->conf = b & 0x1F;
+        return 0;
+    case 2:
+    case 3:
+    {
+        S16 *r = (m->ptr == 2) ? &m->thyst : &m->tos;
+        if (index == 1) *r = (S16)((*r & 0x00FF) | ((U16)b << 8));
+        else if (index == 2) *r = (S16)((*r & 0xFF00) | (b & 0x80));
+        else return 1;
+        return 0;
+    }
+    default:
+        return 1;                               // Temperature register is read-only
+    }
+}
+
+static U8 lm75Read(SimSlave *s)
+{
+    Lm75Model *m = (Lm75Model *)s;
+    S16 r;
+    switch (m->ptr)
+    {
+    case 0:  r = (S16)(m->temp8 << 5); break;
+    case 1:  return m->conf;
+    case 2:  r = m->thyst; break;
+    default: r = m->tos; break;
+    }
+    m->byteSel ^= 1;
+    return m->byteSel ? (U8)((U16)r >> 8) : (U8)(r & 0xFF);
+}
+
+static void lm75Stop(SimSlave *s)
+{
+    (void)s;
+}
+
+// ---------- Public API ----------
+void lm75Init(Lm75Model *m, U8 addr)
+{
+    U8 i;
+    m->slave.name = "LM75";
+    m->slave.addr = addr;
+    m->slave.standardOnly = 0;                  // Fast-mode part (fSCL <= 400 kHz)
+    m->slave.onAddressed = lm75Addressed;
+    m->slave.onWrite = lm75Write;
+    m->slave.onRead = lm75Read;
+    m->slave.onStop = lm75Stop;
+    m->ptr = 0;
+    m->conf = 0;
+    m->thyst = 75 << 8;
+    m->tos = 80 << 8;
+    m->temp8 = 25 * 8;
+    m->os = 1;
+    m->faults = 0;
+    m->byteSel = 0;
+    m->lastConv = simCycles;
+    for (i = 0; i < devCount && devs[i] != m; i++) ;
+    if (i == devCount && devCount < LM75_MAX_DEVS) devs[devCount++] = m;
+    simAttach(&m->slave);
+}
+
+void lm75SetTemp(Lm75Model *m, S16 temp8)
+{
+    lm75Convert(m);                             // Conversions so far used the old value
+    m->temp8 = temp8;
+}
+
+void lm75Reset(void)
+{
+    devCount = 0;                               // Forget the previous scenario's sensors
+}
+
+U8 lm75OsLine(void)
+{
+    U8 i, line = 1;
+    for (i = 0; i < devCount; i++)
+    {
+        lm75Convert(devs[i]);
+        line &= devs[i]->os;                    // Open-drain outputs share the pull-up
+    }
+    return line;
+}
@@ -0,0 +1,399 @@
+// ================== sim_bus.c ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// Wired-AND SDA/SCL lines, SYSCLK cycle counter, the slave protocol engine shared
+// by the device models, IC timing checks and fault injection (see sim_bus.h).
+#include <stdio.h>
+#include <stdarg.h>
+#include "sim_bus.h"
+
+// ---------- Slave Engine States ----------
+#define SIM_ST_IDLE     0       // Waiting for START
+#define SIM_ST_ADDR     1       // Receiving the address byte
+#define SIM_ST_ADDR_ACK 2       // Driving ACK for our address
+#define SIM_ST_RX       3       // Receiving a data byte (master writes)
+#define SIM_ST_RX_ACK   4       // Driving ACK/NACK for a received byte
+#define SIM_ST_TX       5       // Transmitting a data byte (master reads)
+#define SIM_ST_TX_ACK   6       // Master drives ACK/NACK for our byte
+#define SIM_ST_SKIP     7       // Not addressed / read ended by NACK -> wait for START/STOP
+
+// ---------- IC Timing Limits (ns) ----------
+typedef struct
+{
+    U16 low, high, hdSta, suSto, buf, suSta;
+} SimTiming;
+
+static const SimTiming timingStd  = { 4700, 4000, 4000, 4000, 4700, 4700 };  // 100 kHz
+static const SimTiming timingFast = { 1300,  600,  600,  600, 1300,  600 };  // 400 kHz
+
+// ---------- Bus State ----------
+U32 simCycles = 0;
+U16 simViolations = 0;
+U16 simSclClocks = 0;
+U8  simQuiet = 0;
+
+static const SimTiming *timing = &timingStd;
+static U8  stdTran = 0;                 // A Standard-mode-only slave is addressed: check its transaction at 100 kHz
+static U32 minLow, minHigh;             // Shortest SCL LOW / HIGH since the last START
+static SimSlave *slaves = 0;            // Attached devices
+static U8  mSda = 1, mScl = 1;          // Master outputs
+static U8  lineSda = 1, lineScl = 1;    // Resolved wired-AND levels
+static U8  stuckSda = 1;                // Fault: SDA pulled low by a stuck slave
+static U8  stuckClocks = 0;             // SCL pulses until the stuck slave lets go
+static U32 sclHold = 0;                 // Fault: hold SCL low after the next release
+static U8  sclHeld = 0;                 // SCL currently held low by the fault
+static U32 sclReleaseAt = 0;            // simCycles at which the held SCL is released
+static U32 tSclRise = 0, tSclFall = 0;  // Last SCL edges
+static U32 tStart = 0, tStop = 0;       // Last START / STOP
+static U8  startPending = 0;            // START seen, first SCL fall not yet checked
+static U8  stopSeen = 1;                // Bus free since tStop (tBUF applies to the next START)
+
+// simViolation(): Reports a protocol or timing violation with the current cycle stamp.
+void simViolation(const char *who, const char *fmt, ...)
+{
+    va_list ap;
+    simViolations++;
+    if (simQuiet) return;
+    printf("    !! %9lu cyc  %-7s ", (unsigned long)simCycles, who);
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+}
+
+// limits(): Timing limits for the running transaction (Standard mode for a DS1307).
+static const SimTiming *limits(void)
+{
+    return stdTran ? &timingStd : timing;
+}
+
+// checkMin(): Timing check helper, `cycles` measured on the bus against a limit in ns.
+static void checkMin(const char *what, U32 cycles, U16 limitNs)
+{
+    U32 ns = SIM_CYCLES_NS(cycles);
+    if (ns < limitNs)
+        simViolation("timing", "%s = %lu ns < %u ns", what, (unsigned long)ns, limitNs);
+}
+
+// ---------- Slave Protocol Engine ----------
+// slaveCondition(): START (start = 1) or STOP seen while SCL is HIGH.
+static void slaveCondition(SimSlave *s, U8 start)
+{
+    const char *cond = start ? "START" : "STOP";
+    if (!s->err)
+    {
+        // The SCL pulse that carries a START/STOP was already counted as bit 1
+        if (s->state == SIM_ST_TX && s->bits <= 1)
+            simViolation(s->name, "%s after an ACKed read byte (last byte must be NACKed)", cond);
+        else if ((s->state == SIM_ST_ADDR || s->state == SIM_ST_RX || s->state == SIM_ST_TX) && s->bits > 1)
+            simViolation(s->name, "%s inside a byte (after %u bits)", cond, s->bits - 1);
+    }
+    if (s->state != SIM_ST_IDLE && s->state != SIM_ST_SKIP && s->state != SIM_ST_ADDR && !start)
+        s->onStop(s);
+    s->sda = 1;
+    s->err = 0;
+    s->bits = 0;
+    s->shift = 0;
+    s->state = start ? SIM_ST_ADDR : SIM_ST_IDLE;
+}
+
+// slaveSclRise(): Data is sampled while SCL is HIGH.
+static void slaveSclRise(SimSlave *s)
+{
+    switch (s->state)
+    {
+    case SIM_ST_ADDR:
+    case SIM_ST_RX:
+        s->shift = (U8)((s->shift << 1) | lineSda);
+        s->bits++;
+        break;
+    case SIM_ST_TX:
+        if (!mSda && !s->err)               // Master must release SDA while we transmit
+        {
+            simViolation(s->name, "master drives SDA during read data (missing NACK before STOP?)");
+            s->err = 1;
+        }
+        s->bits++;
+        break;
+    case SIM_ST_TX_ACK:
+        s->index = lineSda;                 // Remember ACK (0) / NACK (1) until SCL falls
+        break;
+    default:
+        break;
+    }
+}
+
+// txBit(): Puts the next read-data bit on SDA (MSB first).
+static void txBit(SimSlave *s)
+{
+    s->sda = (U8)((s->shift >> (7 - s->bits)) & 1);
+}
+
+// slaveSclFall(): Outputs change while SCL is LOW.
+static void slaveSclFall(SimSlave *s)
+{
+    switch (s->state)
+    {
+    case SIM_ST_ADDR:
+        if (s->bits < 8) break;
+        if ((s->shift >> 1) == s->addr)
+        {
+            U8 rd = s->shift & 1;
+            if (s->standardOnly && !stdTran)    // Its address byte was clocked already: check it now
+            {
+                stdTran = 1;
+                checkMin("tLOW (address byte)", minLow, timingStd.low);
+                checkMin("tHIGH (address byte)", minHigh, timingStd.high);
+            }
+            s->sda = 0;                     // ACK our address
+            s->state = SIM_ST_ADDR_ACK;
+            s->index = rd;
+            s->onAddressed(s, rd);
+        }
+        else
+            s->state = SIM_ST_SKIP;         // Another device (or nobody) is addressed
+        break;
+    case SIM_ST_ADDR_ACK:
+        s->bits = 0;
+        if (s->index)                       // Read: first data bit right after the ACK clock
+        {
+            s->shift = s->onRead(s);
+            s->state = SIM_ST_TX;
+            txBit(s);
+        }
+        else
+        {
+            s->sda = 1;
+            s->shift = 0;
+            s->index = 0;
+            s->state = SIM_ST_RX;
+        }
+        break;
+    case SIM_ST_RX:
+        if (s->bits < 8) break;
+        s->sda = s->onWrite(s, s->index++, s->shift) ? 1 : 0;
+        s->state = SIM_ST_RX_ACK;
+        break;
+    case SIM_ST_RX_ACK:
+        s->sda = 1;
+        s->bits = 0;
+        s->shift = 0;
+        s->state = SIM_ST_RX;
+        break;
+    case SIM_ST_TX:
+        if (s->bits < 8) { txBit(s); break; }
+        s->sda = 1;                         // Release SDA for the master's ACK/NACK
+        s->state = SIM_ST_TX_ACK;
+        break;
+    case SIM_ST_TX_ACK:
+        if (s->index)                       // NACK: master is done, wait for STOP
+        {
+            s->state = SIM_ST_SKIP;
+            break;
+        }
+        s->bits = 0;
+        s->shift = s->onRead(s);
+        s->state = SIM_ST_TX;
+        txBit(s);
+        break;
+    default:
+        break;
+    }
+}
+
+// ---------- Line Resolution ----------
+static U8 resolveSda(void)
+{
+    U8 v = mSda & stuckSda;
+    SimSlave *s;
+    for (s = slaves; s; s = s->next) v &= s->sda;
+    return v;
+}
+
+// sclEdge(): Timing checks + engine for an SCL transition.
+static void sclEdge(U8 rise)
+{
+    SimSlave *s;
+    if (rise)
+    {
+        simSclClocks++;
+        if (!startPending && !stopSeen)
+        {
+            checkMin("tLOW", simCycles - tSclFall, limits()->low);
+            if (simCycles - tSclFall < minLow) minLow = simCycles - tSclFall;
+        }
+        tSclRise = simCycles;
+        if (stuckClocks) stuckClocks--;
+        for (s = slaves; s; s = s->next) slaveSclRise(s);
+    }
+    else
+    {
+        if (startPending)
+        {
+            checkMin("tHD;STA", simCycles - tStart, limits()->hdSta);
+            startPending = 0;
+        }
+        else if (!stopSeen)
+        {
+            checkMin("tHIGH", simCycles - tSclRise, limits()->high);
+            if (simCycles - tSclRise < minHigh) minHigh = simCycles - tSclRise;
+        }
+        tSclFall = simCycles;
+        stopSeen = 0;
+        if (!stuckSda && !stuckClocks) stuckSda = 1;     // Stuck slave lets go after its last clock
+        for (s = slaves; s; s = s->next) slaveSclFall(s);
+    }
+}
+
+// sdaEdge(): SDA transitions while SCL is HIGH are START (falling) and STOP (rising).
+static void sdaEdge(U8 rise)
+{
+    SimSlave *s;
+    if (!lineScl) return;                   // Normal data change
+    if (rise)
+    {
+        checkMin("tSU;STO", simCycles - tSclRise, limits()->suSto);
+        stdTran = 0;
+        tStop = simCycles;
+        stopSeen = 1;
+        startPending = 0;
+    }
+    else
+    {
+        if (stopSeen)
+            checkMin("tBUF", simCycles - tStop, timing->buf);
+        else
+            checkMin("tSU;STA", simCycles - tSclRise, limits()->suSta);
+        tStart = simCycles;
+        minLow = minHigh = 0xFFFFFFFFUL;
+        startPending = 1;
+    }
+    for (s = slaves; s; s = s->next) slaveCondition(s, !rise);
+}
+
+// busUpdate(): Resolves both lines until stable, firing edge handlers (SCL first).
+static void busUpdate(void)
+{
+    for (;;)
+    {
+        U8 scl = mScl & !sclHeld;
+        U8 sda;
+        if (scl != lineScl)
+        {
+            lineScl = scl;
+            simVcdLine(1, scl);
+            sclEdge(scl);
+            continue;
+        }
+        sda = resolveSda();
+        if (sda == lineSda) break;
+        lineSda = sda;
+        simVcdLine(0, sda);
+        sdaEdge(sda);
+    }
+}
+
+// ---------- Time ----------
+void simDelayCycles(U32 cycles)
+{
+    simVcdAdvance(simCycles + cycles);      // PWM edges inside the delay
+    simCycles += cycles;
+    if (sclHeld && sclReleaseAt != 0xFFFFFFFFUL && simCycles >= sclReleaseAt)
+    {
+        sclHeld = 0;                        // Stretching slave releases SCL
+        busUpdate();
+    }
+}
+
+void delay_us(U16 us) { simDelayCycles((U32)us * (SIM_SYSCLK / 1000000UL)); }
+void delay_ms(U16 ms) { simDelayCycles((U32)ms * (SIM_SYSCLK / 1000UL)); }
+
+// ---------- Pins ----------
+void simSdaOut(U8 level)
+{
+    mSda = level ? 1 : 0;
+    busUpdate();
+}
+
+void simSclOut(U8 level)
+{
+    mScl = level ? 1 : 0;
+    if (mScl && sclHold)                    // Fault armed: the release is stretched
+    {
+        sclHeld = 1;
+        sclReleaseAt = (sclHold == 0xFFFFFFFFUL) ? sclHold : simCycles + sclHold;
+        sclHold = 0;
+    }
+    busUpdate();
+}
+
+U8 simSdaIn(void)
+{
+    return lineSda;
+}
+
+U8 simSclIn(void)
+{
+    U8 v = lineScl;
+    if (!v) simDelayCycles(SIM_POLL_CYCLES);    // One more poll iteration in sclHigh()
+    return v;
+}
+
+// ---------- Setup and Faults ----------
+void simReset(U8 fastMode)
+{
+    simVcdRebase();
+    timing = fastMode ? &timingFast : &timingStd;
+    stdTran = 0;
+    slaves = 0;
+    mSda = mScl = lineSda = lineScl = 1;
+    stuckSda = 1;
+    stuckClocks = 0;
+    sclHold = 0;
+    sclHeld = 0;
+    simCycles = 0;
+    simViolations = 0;
+    simSclClocks = 0;
+    tSclRise = tSclFall = tStart = 0;
+    tStop = (U32)0 - (U32)SIM_SYSCLK;              // Bus has been free for a long time
+    startPending = 0;
+    stopSeen = 1;
+    simVcdLine(1, 1);                       // Idle bus in the VCD
+    simVcdLine(0, 1);
+}
+
+void simAttach(SimSlave *s)
+{
+    s->state = SIM_ST_IDLE;
+    s->sda = 1;
+    s->err = 0;
+    s->bits = 0;
+    s->next = slaves;
+    slaves = s;
+}
+
+void simDetach(SimSlave *s)
+{
+    SimSlave **p;
+    for (p = &slaves; *p; p = &(*p)->next)
+        if (*p == s) { *p = s->next; break; }
+    busUpdate();
+}
+
+void simStickSda(U8 clocks)
+{
+    stuckSda = 0;
+    stuckClocks = clocks;
+    busUpdate();
+}
+
+void simHoldScl(U32 cycles)
+{
+    sclHold = cycles;
+    if (!cycles && sclHeld)                 // 0 also ends a hold in progress
+    {
+        sclHeld = 0;
+        busUpdate();
+    }
+}
@@ -0,0 +1,140 @@
+// ================== sim_bus.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// Pin-level IC bus simulation for the bit-banged driver in my_private_header.h.
+// ----------------------------------------------------------
+// [1] Simulated Time:
+//     -> simCycles counts SYSCLK cycles; the driver's I2C_LOW()/I2C_HIGH()
+//        delay loops, SCL polls and delay_us()/delay_ms() advance it
+// [2] Bus Lines:
+//     -> SDA/SCL are wired-AND: master output & every slave output & faults
+//     -> simSdaOut()/simSclOut()/simSdaIn()/simSclIn() replace the sbit access
+//        (SDA_OUT/SCL_OUT/SDA_IN/SCL_IN in my_private_header.h)
+// [3] Slave Protocol Engine (SimSlave):
+//     -> Every attached device decodes START/STOP/bits/ACK from the pin
+//        transitions itself and drives SDA for ACK and read data
+//     -> Devices only supply byte callbacks (addressed, write, read, stop)
+// [4] Checks and Fault Injection:
+//     -> Protocol violations and IC timing (tLOW, tHIGH, tHD;STA, tSU;STO, tBUF)
+//        are reported with the cycle stamp and counted in simViolations
+//     -> A transaction addressed to a standardOnly device (DS1307) is held to the
+//        Standard-mode limits from its address byte up to the STOP
+//     -> Faults: SDA held low for n clocks (slave stuck mid-byte), SCL held
+//        low (clock stretching / dead slave)
+// [5] Device Models:
+//     -> LM75 (lm75_model.c), DS1307 (ds1307_model.c)
+// [6] Trace and VCD Export (sim_vcd.c):
+//     -> SDA/SCL levels, the firmware trace code (TRACE() in trace.h) and modelled
+//        servo PWM outputs, time-stamped from simCycles, in a VCD file for GTKWave
+//     -> Time keeps running across simReset(), so one file holds the whole run
+//     -> The PWM compare values come from a PCA_ISR stand-in called at every frame
+//        start (simPcaFrame()), e.g. servoStep() from servo.h
+#ifndef SIM_BUS_H
+#define SIM_BUS_H
+
+#include "compiler_defs.h"
+
+// ---------- [1] Simulated Time ----------
+#define SIM_SYSCLK      48000000UL  // Must match SYSCLK in my_private_header.h
+#define SIM_POLL_CYCLES 8           // Cost of one SCL read-back poll in sclHigh() (JNB + DJNZ)
+#define SIM_CYCLES_NS(c) ((U32)(((c) * 1000ULL) / (SIM_SYSCLK / 1000000UL)))  // cycles -> ns
+
+extern U32 simCycles;               // SYSCLK cycles since simReset()
+
+void simDelayCycles(U32 cycles);    // Advance time (and let held lines release)
+void delay_us(U16 us);              // Host versions of the vendor delay routines
+void delay_ms(U16 ms);
+
+// ---------- [2] Bus Lines ----------
+void simSdaOut(U8 level);           // Master SDA driver (0 = pull low, else release)
+void simSclOut(U8 level);           // Master SCL driver
+U8   simSdaIn(void);                // Wired-AND SDA level
+U8   simSclIn(void);                // Wired-AND SCL level (charges SIM_POLL_CYCLES while low)
+
+// ---------- [3] Slave Protocol Engine ----------
+typedef struct SimSlave SimSlave;
+struct SimSlave
+{
+    const char *name;               // Used in violation reports
+    U8  addr;                       // 7-bit address
+    U8  standardOnly;               // 1 = rated for 100 kHz: its transactions are checked against
+                                    //     the Standard-mode limits in both timing profiles
+    // Byte-level device callbacks (called by the engine at the matching SCL edge)
+    void (*onAddressed)(SimSlave *s, U8 read);      // Address matched (START or repeated START)
+    U8   (*onWrite)(SimSlave *s, U8 index, U8 b);   // Byte received; return 0 = ACK, 1 = NACK
+    U8   (*onRead)(SimSlave *s);                    // Next byte to transmit
+    void (*onStop)(SimSlave *s);                    // STOP ended the transaction
+    // Engine state (owned by sim_bus.c)
+    U8  state;                      // SIM_ST_xxx
+    U8  shift;                      // Byte being received / transmitted
+    U8  bits;                       // Bits shifted in the current byte
+    U8  index;                      // Data byte index within the current write
+    U8  sda;                        // SDA output of this device (1 = released)
+    U8  err;                        // Violation already reported in this transaction
+    SimSlave *next;                 // Attached-device list
+};
+
+void simReset(U8 fastMode);         // Clear bus, time, faults, devices and counters
+void simAttach(SimSlave *s);        // Put a device on the bus
+void simDetach(SimSlave *s);        // Remove it (e.g. "unplugged sensor" scenarios)
+
+// ---------- [4] Checks and Fault Injection ----------
+extern U16 simViolations;           // Protocol/timing violations reported so far
+extern U16 simSclClocks;            // SCL rising edges seen on the bus
+extern U8  simQuiet;                // 1 = count violations without printing them
+
+void simViolation(const char *who, const char *fmt, ...);
+void simStickSda(U8 clocks);        // Hold SDA low until `clocks` SCL pulses have passed
+void simHoldScl(U32 cycles);        // Hold SCL low for `cycles` after its next release (0xFFFFFFFF = forever, 0 = release)
+
+// ---------- [5] Device Models ----------
+// LM75: temperature in 1/8 C, comparator O.S. output with fault queue, 100 ms conversions
+typedef struct
+{
+    SimSlave slave;                 // Must be first (callbacks cast SimSlave * -> Lm75Model *)
+    U8  ptr;                        // Register pointer (0..3)
+    U8  conf;                       // Configuration register
+    S16 thyst, tos;                 // Raw 16-bit register images (MSB = C, bit 7 = 0.5 C)
+    S16 temp8;                      // Die temperature in 1/8 C (set by the scenario)
+    U8  os;                         // O.S. output level (0 = active)
+    U8  faults;                     // Consecutive out-of-range conversions (fault queue)
+    U8  byteSel;                    // MSB/LSB toggle while reading 16-bit registers
+    U32 lastConv;                   // simCycles of the last conversion
+} Lm75Model;
+
+void lm75Init(Lm75Model *m, U8 addr);           // Power-on state, attached to the bus
+void lm75SetTemp(Lm75Model *m, S16 temp8);      // Change the die temperature
+void lm75Reset(void);                           // Remove every LM75 from the O.S. line (call with simReset)
+U8   lm75OsLine(void);                          // Wired-OR O.S. line of every LM75 (0 = active)
+
+// DS1307: 64-byte register file (0x00-0x07 clock/control, 0x08-0x3F NVRAM)
+typedef struct
+{
+    SimSlave slave;                 // Must be first
+    U8  reg[64];                    // Register file (BCD clock registers, NVRAM)
+    U8  ptr;                        // Register pointer (auto-increments, wraps 0x3F -> 0x00)
+    U8  shadow[8];                  // Clock registers latched at START (user buffer)
+    U32 lastTick;                   // simCycles of the last whole second
+} Ds1307Model;
+
+void ds1307Init(Ds1307Model *m);                // Power-on state: CH = 1 (oscillator halted), NVRAM cleared
+void ds1307Update(Ds1307Model *m);              // Advance the clock to simCycles
+
+// ---------- [6] Trace and VCD Export ----------
+#define SIM_PWM_COUNT   4           // PCA servo channels in the VCD (pwm0..pwm3)
+#define SIM_PCA_CYCLES  12          // SYSCLK cycles per PCA tick (SYSCLK / 12)
+#define SIM_TRACE_CYCLES 8          // One TRACE() hook on the target (TRACE_MODE 1: MOV + ANL + ORL)
+
+U8   simVcdOpen(const char *path);  // Start recording (0 = file could not be created)
+void simVcdClose(void);
+void simTrace(U8 tr);               // Trace code of the firmware (TRACE() in SIM_HOST builds)
+// PCA overflow handler (the firmware's PCA_ISR): called at every frame start, returns
+// the channel's compare value for that frame (0 = output low); 0 = no handler
+void simPcaFrame(U16 (*isr)(U8 ch));
+// Called by sim_bus.c
+void simVcdLine(U8 scl, U8 level);  // Resolved SCL (scl = 1) or SDA level changed
+void simVcdAdvance(U32 to);         // PWM edges up to simCycles = to (before time moves on)
+void simVcdRebase(void);            // simReset(): keep the VCD time running, PWM and trace code off
+
+#endif
@@ -0,0 +1,169 @@
+// ================== sim_vcd.c ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST)
+// Overview:
+// VCD (Value Change Dump) export of the simulated pins for GTKWave (see sim_bus.h [6]).
+// ----------------------------------------------------------
+// Signals (module c8051f380):
+//   scl, sda     resolved IC line levels (wired-AND of master, slaves and faults)
+//   trace[3:0]   trace-port code of the firmware (TR_xxx in trace.h), as on P1.4..P1.7
+//   pwm0..pwm3   PCA 16-bit PWM outputs: LOW until the counter reaches the compare
+//                value, HIGH up to the overflow; at every overflow the PCA_ISR
+//                stand-in (simPcaFrame()) supplies the compare values of the new frame
+// Time: 1 ns resolution from simCycles (48 MHz -> 20.8 ns steps). simReset() only
+// rebases simCycles, so scenarios follow each other in one file. The frame engine
+// runs with or without a file, so the PCA_ISR stand-in sees every frame either way.
+// View: gtkwave i2c_sim.vcd
+#include <stdio.h>
+#include "sim_bus.h"
+
+#define VCD_FRAME   (65536ULL * SIM_PCA_CYCLES)     // PCA overflow period (16.4 ms)
+#define VCD_SCL     '!'                             // Signal identifiers
+#define VCD_SDA     '"'
+#define VCD_TRACE   '#'
+#define VCD_PWM     '$'                             // '$' + channel
+
+static FILE *vcd = 0;
+static unsigned long long vcdBase = 0;              // Cycles before the last simReset()
+static unsigned long long vcdStampNs = ~0ULL;       // Last time stamp written
+static U8  vcdScl = 1, vcdSda = 1, vcdTrace = 0;    // Levels last written
+static U16 pwmCmp[SIM_PWM_COUNT];                   // Compare value of the running frame (0 = off)
+static U8  pwmLevel[SIM_PWM_COUNT];                 // Output level last written
+static U16 (*pcaIsr)(U8 ch) = 0;                    // PCA overflow handler (simPcaFrame())
+
+// ---------- Output ----------
+// vcdStamp(): Time stamp for the next value changes (absolute cycles).
+static void vcdStamp(unsigned long long cycles)
+{
+    unsigned long long ns = cycles * 1000ULL / (SIM_SYSCLK / 1000000UL);
+    if (ns == vcdStampNs) return;
+    fprintf(vcd, "#%llu\n", ns);
+    vcdStampNs = ns;
+}
+
+static void vcdBit(unsigned long long cycles, char id, U8 level)
+{
+    if (!vcd) return;                               // Frames also run without a file
+    vcdStamp(cycles);
+    fprintf(vcd, "%c%c\n", level ? '1' : '0', id);
+}
+
+static void vcdTraceValue(unsigned long long cycles, U8 tr)
+{
+    vcdStamp(cycles);
+    fprintf(vcd, "b%u%u%u%u %c\n", (tr >> 3) & 1, (tr >> 2) & 1, (tr >> 1) & 1, tr & 1, VCD_TRACE);
+}
+
+static unsigned long long vcdNow(void)
+{
+    return vcdBase + simCycles;
+}
+
+// ---------- File ----------
+U8 simVcdOpen(const char *path)
+{
+    U8 ch;
+    vcd = fopen(path, "w");
+    if (!vcd) return 0;
+    fprintf(vcd, "$version i2c_sim (SIM_HOST) $end\n$timescale 1ns $end\n");
+    fprintf(vcd, "$scope module c8051f380 $end\n");
+    fprintf(vcd, "$var wire 1 %c scl $end\n$var wire 1 %c sda $end\n", VCD_SCL, VCD_SDA);
+    fprintf(vcd, "$var wire 4 %c trace [3:0] $end\n", VCD_TRACE);
+    for (ch = 0; ch < SIM_PWM_COUNT; ch++)
+        fprintf(vcd, "$var wire 1 %c pwm%u $end\n", VCD_PWM + ch, ch);
+    fprintf(vcd, "$upscope $end\n$enddefinitions $end\n");
+    vcdStampNs = ~0ULL;
+    vcdStamp(vcdNow());
+    fprintf(vcd, "$dumpvars\n%c%c\n%c%c\n", vcdScl ? '1' : '0', VCD_SCL, vcdSda ? '1' : '0', VCD_SDA);
+    vcdTraceValue(vcdNow(), vcdTrace);
+    for (ch = 0; ch < SIM_PWM_COUNT; ch++)
+        vcdBit(vcdNow(), VCD_PWM + ch, pwmLevel[ch]);
+    fprintf(vcd, "$end\n");
+    return 1;
+}
+
+void simVcdClose(void)
+{
+    if (!vcd) return;
+    vcdStampNs = ~0ULL;
+    vcdStamp(vcdNow());                             // End of the run: last levels stay visible
+    fclose(vcd);
+    vcd = 0;
+}
+
+// ---------- Signals ----------
+void simVcdLine(U8 scl, U8 level)
+{
+    U8 *last = scl ? &vcdScl : &vcdSda;
+    if (*last == level) return;
+    *last = level;
+    if (vcd) vcdBit(vcdNow(), scl ? VCD_SCL : VCD_SDA, level);
+}
+
+void simTrace(U8 tr)
+{
+    tr &= 0x0F;                                     // 4 trace pins
+    if (tr != vcdTrace)
+    {
+        vcdTrace = tr;
+        if (vcd) vcdTraceValue(vcdNow(), tr);
+    }
+    simDelayCycles(SIM_TRACE_CYCLES);               // The hook itself: a stage with no work is still visible
+}
+
+void simPcaFrame(U16 (*isr)(U8 ch))
+{
+    pcaIsr = isr;
+}
+
+// simVcdAdvance(): PWM edges between now and simCycles = to, in time order; the
+// PCA_ISR stand-in runs at every overflow on the way.
+void simVcdAdvance(U32 to)
+{
+    unsigned long long now = vcdNow(), end = vcdBase + to, frame, t, rise = 0;
+    U8 ch, first, active = 0;
+    for (ch = 0; ch < SIM_PWM_COUNT; ch++) active |= pwmCmp[ch] | pwmLevel[ch];
+    if (!active && !pcaIsr) return;                 // No servo running: nothing to add
+    for (;;)
+    {
+        frame = now - now % VCD_FRAME;              // Start of the running PCA period
+        for (;;)                                    // Compare matches in this frame, earliest first
+        {
+            first = SIM_PWM_COUNT;
+            for (ch = 0; ch < SIM_PWM_COUNT; ch++)
+            {
+                if (!pwmCmp[ch] || pwmLevel[ch]) continue;
+                t = frame + (unsigned long long)pwmCmp[ch] * SIM_PCA_CYCLES;
+                if (t > end) continue;
+                if (t < now) t = now;               // Match before the file was opened
+                if (first == SIM_PWM_COUNT || t < rise) { first = ch; rise = t; }
+            }
+            if (first == SIM_PWM_COUNT) break;
+            pwmLevel[first] = 1;
+            vcdBit(rise, VCD_PWM + first, 1);
+        }
+        t = frame + VCD_FRAME;                      // Overflow: outputs LOW, PCA_ISR loads the new frame
+        if (t > end) break;
+        for (ch = 0; ch < SIM_PWM_COUNT; ch++)
+        {
+            if (pwmLevel[ch]) vcdBit(t, VCD_PWM + ch, 0);
+            pwmLevel[ch] = 0;
+            pwmCmp[ch] = pcaIsr ? pcaIsr(ch) : 0;
+        }
+        now = t;
+    }
+}
+
+void simVcdRebase(void)
+{
+    U8 ch;
+    simVcdAdvance(simCycles);
+    vcdBase += simCycles;
+    for (ch = 0; ch < SIM_PWM_COUNT; ch++)
+    {
+        if (pwmLevel[ch]) vcdBit(vcdBase, VCD_PWM + ch, 0);
+        pwmLevel[ch] = 0;
+        pwmCmp[ch] = 0;
+    }
+    simTrace(0);
+}
@@ -0,0 +1,81 @@
+// ================== solar_ref.c ==================
+// Project: Smart Irrigation System - Final Project
+// Target: Host simulation (gcc/clang, -DSIM_HOST, link with -lm)
+// Overview:
+// Accuracy check of the fixed-point sunrise/sunset solver (solar.h) against the
+// same NOAA series evaluated in double precision with libm trigonometry.
+// ----------------------------------------------------------
+// Every day of a leap year at several latitudes (equator to 68 N, which has
+// polar day and night; both hemispheres) at the site longitude and time zone.
+// The solver reports whole minutes, so up to 0.5 min of the error is its rounding.
+// Days shorter than 2 h or longer than 22 h are skipped (cos H near +-1: the
+// hour angle is ill-conditioned there); a missed crossing on the other days fails.
+// solarCalc() runs with the target's widths: S32 is int32_t here (compiler_defs.h)
+// and solar.h types its constants (S32), so an intermediate beyond 32 bits wraps
+// as on the C51 instead of being carried in a 64-bit long (days over 18 h at 60
+// and 68 N need hour angles > 136, where  86400 did not fit).
+#include <stdio.h>
+#include <math.h>
+#include "compiler_defs.h"
+#include "site_config.h"
+#include "solar.h"
+
+#define SOLAR_MAX_ERR_MIN   1.0     // Pass limit per sunrise/sunset
+
+// refSun(): Reference rise/set in minutes of the local day (unwrapped); 0 = no crossing.
+static U8 refSun(U16 yday, double lat, double lon, double tzMin, double *rise, double *set)
+{
+    double g = 2.0 * M_PI * (yday - 1) / 365.0;
+    double eot = 229.18 * (0.000075 + 0.001868 * cos(g) - 0.032077 * sin(g)
+                           - 0.014615 * cos(2 * g) - 0.040849 * sin(2 * g));
+    double decl = 0.006918 - 0.399912 * cos(g) + 0.070257 * sin(g) - 0.006758 * cos(2 * g)
+                + 0.000907 * sin(2 * g) - 0.002697 * cos(3 * g) + 0.00148 * sin(3 * g);
+    double phi = lat * M_PI / 180.0;
+    double cosH = (sin(-0.833 * M_PI / 180.0) - sin(phi) * sin(decl)) / (cos(phi) * cos(decl));
+    double noon = 720.0 - 4.0 * lon - eot + tzMin;
+    double h;
+    if (cosH >= 1.0 || cosH <= -1.0) return 0;
+    h = acos(cosH) * 720.0 / M_PI;          // Hour angle in minutes
+    if (h < 60.0 || h > 660.0) return 0;   // Within 2 h of polar day/night
+    *rise = noon - h;
+    *set  = noon + h;
+    return 1;
+}
+
+// wrapErr(): |fixed - ref| in minutes, taking the 1440 wrap into account.
+static double wrapErr(S16 fixed, double ref)
+{
+    double d = fmod(fabs(fixed - ref), 1440.0);
+    return d > 720.0 ? 1440.0 - d : d;
+}
+
+U8 solarCheck(void)
+{
+    static const S16 latCdeg[] = { 0, SITE_LAT_CDEG, 4500, 6000, 6800, -3387, -5500 };
+    U8 k, ok = 1;
+    U16 d, days = 0, mismatch = 0;
+    double e, worst = 0.0;
+    for (k = 0; k < sizeof latCdeg / sizeof latCdeg[0]; k++)
+    {
+        double kWorst = 0.0;
+        for (d = 1; d <= 366; d++)
+        {
+            double rise, set;
+            U8 has = refSun(d, latCdeg[k] / 100.0, SITE_LON_CDEG / 100.0, SITE_TZ_MIN, &rise, &set);
+            solarCalc(d, latCdeg[k], SITE_LON_CDEG, SITE_TZ_MIN);
+            if (!has) continue;
+            if (solarRise == SOLAR_NONE) { mismatch++; continue; }
+            e = wrapErr(solarRise, rise);
+            if (e > kWorst) kWorst = e;
+            e = wrapErr(solarSet, set);
+            if (e > kWorst) kWorst = e;
+            days++;
+        }
+        printf("    lat %+7.2f: max error %.2f min\n", latCdeg[k] / 100.0, kWorst);
+        if (kWorst > worst) worst = kWorst;
+    }
+    printf("    %u days, max error %.2f min (limit %.1f), %u missed crossings\n",
+           days, worst, SOLAR_MAX_ERR_MIN, mismatch);
+    if (worst > SOLAR_MAX_ERR_MIN || mismatch) ok = 0;
+    return ok;
+}
@@ -16,27 +16,45 @@
 //     - Initialize PCA (PWM), ADC channels, IC (RTC, temp sensor), SPI (LCD, touch)
 // [5] Main Loop Operations:
 //     (A) Read sensors (ADC and IC)
+//         (every stage of the pass sets its trace-port code, trace.h)
 //     (B) Run irrigation logic (if active)
 //     (C) Detect touchscreen input and button presses
 //     (D) Screen navigation based on user input:
 //          Screen 0 (Main): Displays navigation buttons ("Check", "Setup", "Project")
 //          Screen 1 (Check): Shows real-time sensor data (soil, rain, light, temperature, RTC)
 //           - Additional buttons for displaying specific sensor and time values on demand
-//          Screen 2 (Setup): Allows RTC time adjustments and setting the temperature threshold
+//          Screen 2 (Setup): Allows RTC time/date adjustments and setting the temperature threshold
 //           - Buttons to increment/decrement hours, minutes, and temperature threshold
+//           - Buttons to step day, month and year
 //          Screen 3 (Project): Activates full irrigation logic, shows all sensor data in real-time
+//          Screen 4 (Diag): Clock drift measurement (from the startup screen)
+//          Screen 5 (Why): Why the pump is (not) watering (from the Project screen)
+//          Screen 6 (Cal): Servo end points per channel (from the Check screen "Cal" button)
 // [6] Screen Drawing Functions:
 //     - Create touchscreen buttons and display static UI elements for each screen
 // [7] runProject() Logic:
 //     - Checks combined conditions:
 //          Soil dryness, no significant rain, low ambient light, temperature below threshold
-//          Allowed irrigation time windows (04:0008:00 or 19:0022:00)
-//     - If conditions met: activates relay (pump) and gradually sweeps servo position
-//     - Displays real-time sensor values during operation
+//          Allowed irrigation time windows of today's plan (calendar.h: weekday mask,
+//          odd/even dates; default 04:0008:00 and 19:0022:00 every day)
+//     - If conditions met: activates relay (pump); the servos sweep while it runs (servo.h)
+//     - Records the reason of every decision (decision_trace.h)
+//     - projectShow() displays real-time sensor values during operation
 #include "compiler_defs.h"           // Compiler-specific definitions (macros, types, bit-fields)
 #include "C8051F380_defs.h"          // Special Function Register (SFR) definitions for C8051F380
 #include "initsysSPI.h"              // SPI-based LCD, delay utilities, and touchscreen calibration functions
 #include "my_private_header.h"       // User-defined header: low-level declarations (ADC, servo, IC, etc.)
+#include "sample_policy.h"           // Rate-adaptive per-sensor sampling periods
+#include "sensor_health.h"           // Per-sensor fault classification + fail-safe policy
+#include "shadow_clock.h"            // Timer2 shadow clock + DS1307 drift trim
+#include "site_config.h"            // Site location and watering-window edges
+#include "solar.h"                   // Once-per-day sunrise/sunset solver
+#include "calendar.h"                // Date, weekday schedule and the cached day plan
+#include "rain.h"                    // Rain integrator and rain delay (skipped windows)
+#include "supervisor.h"              // Task deadlines + PCA watchdog
+#include "flow.h"                    // Flow meter: Timer0 pulse counter, volume per window / day
+#include "servo.h"                   // Sprinkler servo channels (PCA modules 0..3, frame interrupt)
+#include "decision_trace.h"          // Reason code of every runProject() decision, per day + last transitions
 // --------------------------------------------------------------------
 // System Threshold Definitions (calibrated values for decision logic)
 // --------------------------------------------------------------------
@@ -44,14 +62,34 @@
 #define RAIN_THRESHOLD    80   // If rain sensor reading = 80%, no significant rain -> safe to irrigate
 #define LIGHT_THRESHOLD   70   // If ambient light < 70%, lighting conditions are suitable for irrigation
 // TEMP_THRESHOLD is defined as a variable below (adjustable in runtime)
+#define SOIL_THRESHOLD_RAW ((SOIL_THRESHOLD * 102 + 9) / 10) // Smallest raw ADC count that scales to >= SOIL_THRESHOLD %
 
 // --------------------- Global Sensor and System Variables ---------------------
 
 float temp;                     // Temperature reading from LM75 (C), received via IC
-int TEMP_THRESHOLD = 27;        // Dynamic temperature threshold (C) for irrigation (default = 27)
-int directionUp;                // Servo sweep direction flag: 1 = increasing angle, 0 = decreasing
-unsigned int angle = 1500;      // PWM pulse width in s for servo position (1500s = center = 90)
+int TEMP_THRESHOLD = 27;        // Dynamic temperature threshold (C) for irrigation (default = 27, saved in DS1307 NVRAM)
 int hour, minute, second;       // RTC time values (hours, minutes, seconds) from DS1307
+// Setup screen edits are staged here and written to the DS1307/LM75s in one commit
+// (leaving the Setup screen, or SETUP_IDLE_MS after the last edit).
+#define SETUP_IDLE_MS   10000   // Idle time after the last +/- press before staged edits are committed
+int setupHour, setupMinute, setupThreshold;  // Staged values shown on the Setup screen
+U8  setupYear, setupMonth, setupDate;       // Staged date (year 0..99 = 2000..2099)
+#define SETUP_TIME      0x01    // setupDirty: hour/minute edited
+#define SETUP_DATE      0x02    // setupDirty: day/month/year edited
+#define SETUP_THR       0x04    // setupDirty: threshold edited
+U8  setupDirty = 0;             // SETUP_xxx bits of the staged values that differ from what is committed
+U16 setupEditTick = 0;          // loopTicks of the last +/- press
+// Touch debounce: a new press is reported at once; a held Setup step key (+/-, D/M/Y)
+// repeats after TOUCH_REPEAT_MS, then every TOUCH_RATE_MS; other buttons act once per press.
+#define TOUCH_REPEAT_MS 400     // Hold time before the first repeat
+#define TOUCH_RATE_MS   200     // Repeat period while held
+#define TOUCH_REPEATS(b) (((b) >= 13 && (b) <= 21 && (b) != 18) || ((b) >= 25 && (b) <= 28)) // Setup / Cal step keys
+#define SERVO_CAL_STEP_US 10    // Cal screen: pulse width change per +/- press (s)
+S16 touchHeld = 0;              // Button under the finger in the previous pass (0 = none)
+U32 touchMs = 0;                // clockNow() of the last reported press/repeat
+bit touchRepeating = 0;         // 1 once the held button has repeated (TOUCH_RATE_MS from then on)
+U32 loopWorkUs = 0;             // Busy time of the last main-loop pass (s, clockUs())
+U32 loopWorkMaxUs = 0;          // Longest busy time since reset (Check screen "Rate" button)
 int rain, soil, light;          // Sensor readings converted to percentages (0100%)
                                 // rain  -> rain sensor (ADC)
                                 // soil  -> soil moisture sensor (ADC)
@@ -65,21 +103,72 @@ void screen0(void);  // Startup screen
 void screen1(void);  // "Check" screen: displays sensor data and time  
 void screen2(void);  // "Setup" screen: allows RTC adjustments  and TEMP_THRESHOLD
 void screen3(void);  // "Project" screen: real-time operation  
+void screen4(void);  // "Diag" screen: clock drift / trim
+void diagShow(void); // Refreshes the Diag screen values
+void screen5(void);  // "Why" screen: decision trace
+void whyShow(void);  // Refreshes the Why screen values
+void screen6(void);  // "Cal" screen: servo end-point calibration
+void servoCalShow(U8 ch); // Refreshes the Cal screen values of one channel
 
 // Main project logic function  executed in PROJECT mode  
 void runProject(void);  
+void projectShow(void);       // Project screen sensor values (while it is shown)
+// Writes the staged Setup values (time/date in one DS1307 burst, threshold to NVRAM)
+void setupCommit(void);
+void setupDateShow(void);     // Prints the staged date into the Setup date field
+void thresholdLoad(void);     // TEMP_THRESHOLD from DS1307 NVRAM (boot)
+S16  touchDebounce(S16 btn);  // Raw ButtonTouch() result -> press / auto-repeat events
 // ---------------- Main Function ----------------  
 void main(void)  
 {  
     S16 x = 0, y = 0;             // Variables for touchscreen X and Y coordinates  
     S16 ButtonNum = 0;            // Variable for detected button number from touch input  
-    U8 screen = 0;                // Current screen indicator: 0 = startup, 1 = Check, 2 = Setup, 3 = Project  
+    U8 screen = 0;                // Current screen indicator: 0 = startup, 1 = Check, 2 = Setup, 3 = Project, 4 = Diag, 5 = Why, 6 = Cal  
+    U8 rateSel = 0;               // Sensor shown by the Check screen "Rate" button (cycles on each press)  
+    U8 tempSel = 0;               // Check screen "Tempr": 0 = array summary, 1..lm75Count = one sensor  
+    U8 ch;                        // Servo channel (Check screen "Servo")  
+    U8 servoSel = 0;              // Check screen "Servo": 0 = channel angles, 1..SECTOR_COUNT = one sector  
+    U8 servoCalCh = 0;            // Cal screen: channel being calibrated  
+    U16 us0, us180;               // Cal screen: new end points of that channel  
+    int diagSec = -1;             // Second shown on the Diag screen (refresh once per second)  
+    int whySec = -1;              // Second shown on the Why screen (refresh once per second)  
+    S16 adcRaw;                   // Raw ADC sample (0..1023) handed to the health monitor  
+    U8 rtcRegs[7];                // DS1307 0x00..0x06 read once at boot (time -> shadow clock, date -> calendar)  
+    U32 loopStart;                // clockNow() at the start of the current loop pass (pacing)  
+    U32 passUs;                   // clockUs() at the start of the current loop pass (profiling)  
+#if I2C_BENCH
+    U8 benchSel = I2C_BENCH_LM75; // Device benchmarked by the Check screen "I2C" button (alternates)  
+#endif
 
     // ---------- Hardware Initialization ----------  
     Init_Device();                // Initialize hardware: PCA for PWM, ADC channels, I2C pins, oscillator, Enable crossbar + route CEX0 (PWM) to P0.0.  
+    traceStart();                 // Logic-analyzer trace port (TRACE_MODE builds only, trace.h)
+    isrProfileStart();            // Timer1 stamps for the ISR profile (ISR_PROFILE builds only)
+    TRACE(TR_BOOT);
     initSysSpi();                 // Initialize LCD, delays and touch functions  
 	 
     TouchSet(427, 3683, 3802, 438);  // Calibrate the touchscreen with raw min/max X/Y values
+    thresholdLoad();              // Threshold saved by the Setup screen (default if NVRAM is blank)
+    lm75Scan();                   // Find every LM75 on the bus (0x48..0x4F)
+    lm75AlarmAll(TEMP_THRESHOLD); // Program TOS/THYST in all of them -> shared O.S. pin tracks the hottest sensor
+    soilCalibrate();              // Probe settle window (shortest one that matches a long-settled reading)
+    setSoilWindow(SOIL_THRESHOLD_RAW);            // Program ADC0 window -> soil crossings raise an interrupt
+    soilStart();                  // Soil pipeline: excitation -> settle -> convert -> off, on request
+    policy[SENSOR_TEMP].threshold  = TEMP_THRESHOLD;  // Sampling policy: decision points each sensor
+    policy[SENSOR_SOIL].threshold  = SOIL_THRESHOLD;  // speeds up around
+    policy[SENSOR_RAIN].threshold  = RAIN_THRESHOLD;
+    policy[SENSOR_LIGHT].threshold = LIGHT_THRESHOLD;
+    shadowInit(calLoad(rtcRegs) == I2C_OK ? rtcRegs : 0); // One burst of 0x00..0x06: date + time of day,
+                                  // stored drift trim -> Timer2 shadow clock
+    calLastSec = shadowNow();
+    planToday();                  // Today's watering windows (then only at midnight / date change)
+    rainLoad();                   // Pending rain delay / running rain event from NVRAM
+    flowLoad();                   // Today's / yesterday's water volume from NVRAM
+    servoStart();                 // Servo channels + PCA frame interrupt (before the watchdog locks PCA0MD)
+    superRegister(TASK_LOOP, 500);    // Deadlines of the periodic activities (ms)
+    superRegister(TASK_TEMP, 15000);
+    superRegister(TASK_ADC, 10000);
+    superStart();                 // Reset cause, miss record, watchdog on (fed from Timer2 while tasks check in)
 	  // Touch calibration (RAW ADC ranges -> pixel map, 240x320 portrait)
     // TouchSet expects: (Xmin, Xmax, Ymax, Ymin)
     LCD_fillScreen(BLACK);           // Clear the entire LCD screen by filling it with black color
@@ -87,49 +176,137 @@ void main(void)
     screen0();  
 
     // ---------- MAIN LOOP ----------  
+    loopStart = clockNow();
     while(1)  
     {  
-        delay_ms(20);  // Base loop delay (20 ms)  
+        TRACE(TR_IDLE);
+        while (elapsed(loopStart) < LOOP_MS);  // Pass period: LOOP_MS from the start of the previous pass (Timer2)  
+        loopStart = clockNow();
+        passUs = clockUs();
+        loopTicks++;   // Time base for IC age stamps (one tick per loop pass)  
 
         // --- (A) Read Sensors Values ---
-        // Read temperature from LM75 (IC address = 0x48)
+        TRACE(TR_TEMP);                // Trace port: one code per stage, TR_STAGE_FIRST..LAST in order (trace.h)
+        // Each sensor is read only when its sampling policy says it is due
+        // (see sample_policy.h): fast near a decision threshold or while the
+        // value is changing, backing off while it is stable.
+        // Read temperature from every LM75 found at boot (IC addresses 0x48..0x4F)
         // IC format requires 7-bit address + 1-bit R/W flag:
         // (0x48 << 1) = 0x90 -> shifts address left to make room for R/W bit
         // R/W bit = 1 (Read mode), so full byte sent = 0x91
-        temp = readTemp((0x48 << 1) | 1);  // Reads and converts 9-bit digital value to float (C)
+        // The threshold itself is evaluated by the LM75s (shared O.S. pin = hottest
+        // sensor), so the batched read feeds the display and the sampling policy,
+        // and runs right away when the O.S. interrupt fires.
+        // A sensor that fails (after retries) keeps its last good value and is left
+        // out of the min/avg/max aggregate; temp shows the hottest point.
+        if (policyDue(SENSOR_TEMP) || tempRefresh)
+        {
+            tempRefresh = 0;
+            if (lm75SampleAll() && healthSample(SENSOR_TEMP, lm75Max8)) // One pass over all sensors (min/avg/max in 1/8 C)
+                temp = lm75Max8 * 0.125;            // Decision value = hottest point (C)
+            policyUpdate(SENSOR_TEMP, lm75Max8 >> 3);
+            superCheckIn(TASK_TEMP);
+        }
        	// 48 = binnary 1001000
 			  // if master write =1 (0x48 << 1) | 0 -> 10010000 = 0x90
 			  // if master read = 0  (0x48 << 1) | 1 -> 10010001 = 0x91
 			
-			  // Read current time from DS1307 RTC (values are in BCD format)
-        hour   = readDS1307(0x02);   // Read hour register (address 0x02)
-        minute = readDS1307(0x01);   // Read minute register (address 0x01)
-        second = readDS1307(0x00);   // Read second register (address 0x00), CH (Clock Halt) bit masked
+			  // Current time comes from the Timer2 shadow clock (trimmed to the DS1307 rate);
+        // the RTC itself is only read by the drift tracker, around its seconds edges
+        TRACE(TR_CLOCK);
+        driftPoll();
+        calTick(shadowNow());          // Midnight -> next date and a new day plan
+        if (policyDue(SENSOR_TIME))
+        {
+            shadowHms(&hour, &minute, &second); // One consistent HH:MM:SS, no IC
+            policyUpdate(SENSOR_TIME, minute); // Every loop: window edges fall on any minute
+        }
+        rainWindowTick(planAllows(hour * 60 + minute)); // Window openings consume the rain delay
+        flowWindowTick(planAllows(hour * 60 + minute)); // Window openings restart the volume budget
+        TRACE(TR_FLOW);
+        flowPoll();                    // Flow pulses counted by Timer0 -> rate, window and day volume
+        sectorWater(flowDelta);        // ... booked to the sprinkler sector being watered
+        sectorPoll();                  // Sector soil probes -> dwell weights (every SECTOR_PROBE_MS)
   
         // Read ADC sensor values from the defined channels and convert to percentage (0..100)  
-        light = (ADC_IN_CHANNEL(0x00) * 10) / 102; // Light sensor reading from ADC channel 0 (P2.0) scaled to percentage  
-        soil  = (ADC_IN_CHANNEL(0x01) * 10) / 102; // Soil sensor reading from ADC channel 1 (P2.1) scaled to percentage  
-        rain  = (ADC_IN_CHANNEL(0x02) * 10) / 102; // Rain sensor reading from ADC channel 2 (P2.2) scaled to percentage  
+        // The soil threshold is evaluated by the ADC0 window (soilDry) on every pipeline
+        // sample; the probe is only powered for the samples the sampling policy asks for.
+        TRACE(TR_ADC);
+        if (soilTake(&adcRaw))                       // A requested soil sample arrived (excited, settled, converted)
+        {
+            if (healthSample(SENSOR_SOIL, adcRaw))   // Rail / step / stuck check on the raw count
+                soil = ADC_PCT(adcRaw); // Soil sensor reading from ADC channel 1 (P2.1) scaled to percentage  
+            policyUpdate(SENSOR_SOIL, soil);
+        }
+        if (policyDue(SENSOR_SOIL))
+            soilRequest();                           // Next Timer3 tick powers the probe and samples it
+        else
+            adcSuppressed++;                         // Probe stays unpowered this loop
+        if (policyDue(SENSOR_LIGHT))
+        {
+            adcRaw = ADC_IN_CHANNEL(0x00);
+            if (healthSample(SENSOR_LIGHT, adcRaw))
+                light = ADC_PCT(adcRaw); // Light sensor reading from ADC channel 0 (P2.0) scaled to percentage  
+            policyUpdate(SENSOR_LIGHT, light);
+            superCheckIn(TASK_ADC);
+        }
+        if (policyDue(SENSOR_RAIN))
+        {
+            adcRaw = ADC_IN_CHANNEL(0x02);
+            if (healthSample(SENSOR_RAIN, adcRaw))
+                rain  = ADC_PCT(adcRaw); // Rain sensor reading from ADC channel 2 (P2.2) scaled to percentage  
+            policyUpdate(SENSOR_RAIN, rain);
+            rainSample(rain);                        // Wetness  time since the previous sample -> rain index
+            superCheckIn(TASK_ADC);
+        }
+        healthTick();                                // Age stamps: a sensor without samples turns STALE
+
+        TRACE(TR_LOGIC);
+        // Staged Setup edits are committed once the user stops pressing +/-
+        if (setupDirty && (U16)(loopTicks - setupEditTick) >= SETUP_IDLE_MS / LOOP_MS)
+            setupCommit();
 
         // --- (B) Execute PROJECT Mode Logic if Active ---  
         if(runFlag)                    // Check if irrigation flag is active (runFlag == 1)
-        runProject();              // Execute irrigation logic (runProject) only when flag is set
+        {
+            if (screen == 3)
+                projectShow();         // Sensor values (the Why screen keeps the decisions running)
+            runProject();              // Execute irrigation logic (runProject) only when flag is set
+        }
+        servoSweepAll(Relay);          // Sprinklers sweep exactly while the pump runs, park otherwise
+        TRACE(TR_UI);
+        if (screen == 4 && second != diagSec)  // Diag values refresh once per second
+        {
+            diagSec = second;
+            diagShow();
+        }
+        if (screen == 5 && second != whySec)    // Why values refresh once per second
+        {
+            whySec = second;
+            whyShow();
+        }
         // --- (C) Read Touchscreen Input ---  
         x = ReadTouchX();                // Read raw X coordinate from touchscreen controller (after touch detected)
         y = ReadTouchY();                // Read raw Y coordinate from touchscreen controller (after touch detected)
 
-         ButtonNum = ButtonTouch(x, y);  // Determine which button was pressed based on (X, Y) position
+         ButtonNum = touchDebounce(ButtonTouch(x, y));  // Determine which button was pressed based on (X, Y) position
                                          // Returns button index if touch overlaps a defined button area
+                                         // (new press, or auto-repeat while held; 0 otherwise)
  
     // --- (D) Menu Navigation Based on Touchscreen Input ---
     if(ButtonNum != 0)  // A button press was detected (ButtonNum = 0): user requested a screen change
     {
+    if(screen == 2 && ButtonNum <= 3) // Leaving (or redrawing) the Setup screen commits staged edits
+        setupCommit();
+    if(screen == 6 && ButtonNum <= 3) // Leaving the Cal screen parks the channel it held
+        servoRelease(servoCalCh);
     // If "Check" screen button (Button 1) is pressed  
     if(ButtonNum == 1)                
     {  
         screen = 1;                   // Set screen index to 1 (Check screen)
         runFlag = 0;                  // Disable irrigation logic
         Relay_Off();                  // Ensure pump is off before entering Check mode
+        WHY(WHY_OFF);                 // Decision trace: project mode left
         screen1();                    // Display the Check screen (show sensor reading buttons)
     }  
     // If "Setup" screen button (Button 2) is pressed  
@@ -138,6 +315,13 @@ void main(void)
         screen = 2;                   // Set screen index to 2 (Setup screen)
         runFlag = 0;                  // Disable automatic mode to allow manual RTC edits
         Relay_Off();                  // Turn off pump while adjusting settings
+        WHY(WHY_OFF);
+        setupHour = hour;             // Stage the current values; +/- only edit the copies
+        setupMinute = minute;
+        setupThreshold = TEMP_THRESHOLD;
+        setupYear = calYear;
+        setupMonth = calMonth;
+        setupDate = calDate;
         screen2();                    // Display the Setup screen (RTC and threshold adjustments)
     }  
     // If "Project" screen button (Button 3) is pressed  
@@ -147,25 +331,54 @@ void main(void)
         runFlag = 1;                  // Enable automatic irrigation logic (runProject active)
         screen3();                    // Display the Project screen
     }  
+    // If "Diag" button (Button 18, startup screen) is pressed
+    else if(ButtonNum == 18 && screen == 0)
+    {
+        screen = 4;                   // Set screen index to 4 (Diagnostics)
+        screen4();                    // Display the Diag screen
+    }
+    // If "Why" button (Button 22, Project screen) is pressed: irrigation keeps running
+    else if(ButtonNum == 22 && screen == 3)
+    {
+        screen = 5;                   // Set screen index to 5 (decision trace)
+        screen5();                    // Display the Why screen
+    }
+    // If "Cal" button (Button 23, Check screen) is pressed: pump stays off (Check mode)
+    else if(ButtonNum == 23 && screen == 1)
+    {
+        screen = 6;                   // Set screen index to 6 (servo calibration)
+        servoCalCh = 0;
+        screen6();                    // Display the Cal screen
+    }
 
 // --- (D.1) Sub-menu: CHECK Screen Options ---
 if(screen == 1) {                         // Only handle sub-menu actions when current screen is CHECK (1)
     if(ButtonNum == 4) {                  // "Time" button pressed
         LCD_fillRect(10,200,300,40,BLUE); // Clear result area (x=10,y=200,w=300,h=40) with blue background
         LCD_setCursor(15,215);            // Position text cursor inside the result area
-        printf("Time: %02d:%02d:%02d", hour, minute, second); // Print time HH:MM:SS with zero padding
+        printf("%02d:%02d:%02d %s %02u/%02u e%u r%u", hour, minute, second, // Print time HH:MM:SS with zero padding
+               wdayName[calWday], (U16)calDate, (U16)calMonth,     // + weekday and date
+               rtcDev.errors, rtcDev.retries);                        // + DS1307 error / retry counters
     } else if(ButtonNum == 5) {           // "Tempr" button pressed (temperature)
         LCD_fillRect(10,200,300,40,BLUE); // Refresh result area background
         LCD_setCursor(15,215);            // Set cursor for text output
-        printf("Temp: %.2f C", temp);     // Show LM75 temperature with 2 decimals
+        if (tempSel == 0)                 // Summary: sensors answering/found, min/avg/max, bus time of one pass
+            printf("%u/%u %.1f/%.1f/%.1f %uus", (U16)lm75Valid, (U16)lm75Count,
+                   lm75Min8 * 0.125, lm75Avg8 * 0.125, lm75Max8 * 0.125, lm75PassTicks / 4);
+        else                              // One sensor: address, temperature, age (s), errors, retries
+            printf("%02X:%.1fC a%us e%u r%u", (U16)lm75s[tempSel - 1].addr, lm75s[tempSel - 1].t8 * 0.125,
+                   (loopTicks - lm75s[tempSel - 1].dev.stamp) / (1000 / LOOP_MS),
+                   lm75s[tempSel - 1].dev.errors, lm75s[tempSel - 1].dev.retries);
+        if (++tempSel > lm75Count) tempSel = 0;  // Next press shows the next sensor
     } else if(ButtonNum == 6) {           // "Soil" button pressed
         LCD_fillRect(10,200,300,40,BLUE); // Refresh result area
         LCD_setCursor(15,215);            // Set cursor position
-        printf("Soil: %u%%", soil);       // Print soil moisture percentage (0..100)
+        printf("Soil: %u%% on %uus x%u", soil, // Soil moisture percentage (0..100), probe settle window,
+               soilSettleUs, soilMissed);          // samples lost
     } else if(ButtonNum == 7) {           // "Rain" button pressed
         LCD_fillRect(10,200,300,40,BLUE); // Refresh result area
         LCD_setCursor(15,215);            // Set cursor position
-        printf("Rain: %u%%", rain);       // Print rain sensor percentage (0..100)
+        printf("Rain: %u%% idx %u delay %u", rain, rainIndex, (U16)rainDelay); // Reading, rain index (wet-min), windows to skip
     } else if(ButtonNum == 8) {           // "Light" button pressed
         LCD_fillRect(10,200,300,40,BLUE); // Refresh result area
         LCD_setCursor(15,215);            // Set cursor position
@@ -173,60 +386,129 @@ if(screen == 1) {                         // Only handle sub-menu actions when c
     } else if(ButtonNum == 9) {           // "Pump" button pressed
         LCD_fillRect(10,200,300,40,BLUE); // Refresh result area
         LCD_setCursor(15,215);            // Set cursor position
-        if(Relay)                         // Read Relay sbit (P0.2): 1=coil energized (pump ON), 0=OFF
-            printf("Pump: ON");           // Report pump state ON
-        else
-            printf("Pump: OFF");          // Report pump state OFF
+        printf("Pump %s %u.%uL/m D%u.%u Y%u.%uL",   // Pump state, flow rate, today's / yesterday's volume
+               Relay ? "ON" : "OFF",      // Read Relay sbit (P0.2): 1=coil energized (pump ON), 0=OFF
+               flowRate / 1000, flowRate % 1000 / 100,
+               flowDl(flowToday) / 10, flowDl(flowToday) % 10,
+               flowDl(flowYesterday) / 10, flowDl(flowYesterday) % 10);
     } else if(ButtonNum == 10) {          // "Servo" button pressed
         LCD_fillRect(10,200,300,40,BLUE); // Refresh result area
         LCD_setCursor(15,215);            // Set cursor position
-        printf("Servo: %u deg", (unsigned int)((angle - 600) / 10));
+        if (servoSel == 0)                // Angle of every channel (0..180), P = parked (no pulses)
+        {
+            printf("Servo:");
+            for (ch = 0; ch < SERVO_COUNT; ch++)
+                printf(" %u%s", (U16)servoDeg(ch), servoOn(ch) ? "" : "P");
+            printf(" deg");
+        }
+        else                              // One sector: first angle, dwell weight, water today (L)
+            printf("Sec%u %u deg x%u %u.%uL", (U16)servoSel, (U16)sector[servoSel - 1].from,
+                   (U16)sector[servoSel - 1].weight,
+                   flowDl(sector[servoSel - 1].pulses) / 10, flowDl(sector[servoSel - 1].pulses) % 10);
+        if (++servoSel > SECTOR_COUNT) servoSel = 0;  // Next press shows the next sector
 
+    } else if(ButtonNum == 11) {          // "Rate" button pressed (sampling statistics)
+        LCD_fillRect(10,200,300,40,BLUE); // Refresh result area
+        LCD_setCursor(15,215);            // Set cursor position
+        if (rateSel == SENSOR_COUNT)      // Main-loop busy time (profiling)
+            printf("Loop %luus max %luus", loopWorkUs, loopWorkMaxUs);
+#if ISR_PROFILE
+        else if (rateSel > SENSOR_COUNT)  // ISR_PROFILE builds: longest body of each ISR
+            printf("ISR %s max %lucy", isrName[rateSel - SENSOR_COUNT - 1],
+                   isrWorstCycles(rateSel - SENSOR_COUNT - 1));
+#endif
+        else
+            printf("%s n=%u avg=%ums", sensorName[rateSel],   // Sensor name, samples taken,
+                   policy[rateSel].samples, policyAvgMs(rateSel)); // average time between samples
+        if (++rateSel > SENSOR_COUNT + ISR_ROWS) rateSel = 0;   // Next press shows the next sensor
     }
+#if I2C_BENCH
+    else if(ButtonNum == 12) {            // "I2C" button pressed (bus benchmark, bench builds only)
+        i2cBench(benchSel);               // Time I2C_BENCH_REPS transactions with the PCA counter
+        LCD_fillRect(10,200,300,40,BLUE); // Refresh result area
+        LCD_setCursor(15,215);            // Set cursor position
+        printf("%s %ukHz %uB/s", benchSel == I2C_BENCH_LM75 ? "LM75" : "RTC",
+               i2cBenchResult[benchSel].sclKhz, i2cBenchResult[benchSel].bytesPerSec);
+        benchSel ^= 1;                    // Next press benchmarks the other device
+    }
+#endif
 }
  
  // --- (D.2) Sub-menu: Setup Screen for RTC Adjustment  and TEMP_THRESHOLD---
 if(screen == 2) {                             // Handle buttons only when 'Setup' screen is active
+    // +/- only change the staged copies; setupCommit() writes them (see SETUP_IDLE_MS)
+    if(ButtonNum >= 13 && ButtonNum <= 21 && ButtonNum != 18) {
+        if(ButtonNum <= 16)      setupDirty |= SETUP_TIME;  // Something to commit
+        else if(ButtonNum == 17) setupDirty |= SETUP_THR;
+        else                     setupDirty |= SETUP_DATE;
+        setupEditTick = loopTicks;            // Restart the idle timeout
+    }
     if(ButtonNum == 13) {                     // Increase hour (+)
-        hour++;                               // Increment hour value
-        if(hour >= 24) hour = 0;              // Wrap 23 -> 0 (24h format)
-        writeDS1307(0x02, hour);              // Write HOURS register (0x02); function converts to BCD
+        setupHour++;                          // Increment hour value
+        if(setupHour >= 24) setupHour = 0;    // Wrap 23 -> 0 (24h format)
         LCD_fillRect(185,75,80,30,GREEN);     // Clear/redraw the Hour display field
         LCD_setCursor(200,80);                // Position cursor inside the Hour field
-        printf("%d", hour);                   // Show updated hour
+        printf("%d", setupHour);              // Show updated hour
     } else if(ButtonNum == 14) {              // Decrease hour (-)
-        if(hour == 0) hour = 23; else hour--; // Wrap 0 -> 23, otherwise decrement
-        writeDS1307(0x02, hour);              // Update HOURS in RTC (BCD handled inside)
+        if(setupHour == 0) setupHour = 23; else setupHour--; // Wrap 0 -> 23, otherwise decrement
         LCD_fillRect(185,75,80,30,GREEN);     // Refresh Hour field background
         LCD_setCursor(200,80);                // Cursor for printing
-        printf("%d", hour);                   // Print hour
+        printf("%d", setupHour);              // Print hour
     } else if(ButtonNum == 15) {              // Increase minute (+)
-        minute++;                             // Increment minute value
-        if(minute >= 60) minute = 0;          // Wrap 59 -> 0
-        writeDS1307(0x01, minute);            // Write MINUTES register (0x01) in BCD
+        setupMinute++;                        // Increment minute value
+        if(setupMinute >= 60) setupMinute = 0; // Wrap 59 -> 0
         LCD_fillRect(185,115,50,30,GREEN);    // Clear/redraw the Minute field
         LCD_setCursor(200,120);               // Position cursor inside Minute field
-        printf("%d", minute);                 // Show updated minute
+        printf("%d", setupMinute);            // Show updated minute
     } else if(ButtonNum == 16) {              // Decrease minute (-)
-        if(minute == 0) minute = 59; else minute--; // Wrap 0 -> 59, otherwise decrement
-        writeDS1307(0x01, minute);            // Update MINUTES in RTC (BCD handled inside)
+        if(setupMinute == 0) setupMinute = 59; else setupMinute--; // Wrap 0 -> 59, otherwise decrement
         LCD_fillRect(185,115,50,30,GREEN);    // Refresh Minute field background
         LCD_setCursor(200,120);               // Cursor for printing
-        printf("%d", minute);                 // Print minute
+        printf("%d", setupMinute);            // Print minute
     } else if(ButtonNum == 17) {              // Adjust temperature threshold (+/- cycles 20..30C)
-        TEMP_THRESHOLD++;                     // Increment threshold
-        if(TEMP_THRESHOLD > 30) TEMP_THRESHOLD = 20; // Wrap back to 20C after 30C
-        writeDS1307(0x06, TEMP_THRESHOLD);    // (Optional) store threshold in DS1307 register 0x06
+        setupThreshold++;                     // Increment threshold
+        if(setupThreshold > 30) setupThreshold = 20; // Wrap back to 20C after 30C
         LCD_fillRect(185,155,50,30,GREEN);    // Clear/redraw the Threshold field
         LCD_setCursor(200,160);               // Position cursor inside Threshold field
-        printf("%d", TEMP_THRESHOLD);         // Show updated threshold
+        printf("%d", setupThreshold);         // Show updated threshold
+    } else if(ButtonNum == 19) {              // Next day (wraps to 1 after the month's last day)
+        if(++setupDate > calMonthDays(setupMonth, setupYear)) setupDate = 1;
+        setupDateShow();
+    } else if(ButtonNum == 20) {              // Next month (day is clamped on commit)
+        if(++setupMonth > 12) setupMonth = 1;
+        setupDateShow();
+    } else if(ButtonNum == 21) {              // Next year (2000..2099)
+        if(++setupYear > 99) setupYear = 0;
+        setupDateShow();
+    }
+}
+
+// --- (D.3) Sub-menu: Cal Screen (servo end points) ---
+if(screen == 6) {                             // Handle buttons only when 'Cal' screen is active
+    if(ButtonNum == 24) {                     // Next channel: the previous one parks
+        servoRelease(servoCalCh);
+        if(++servoCalCh >= SERVO_COUNT) servoCalCh = 0;
+        servoCalShow(servoCalCh);
+    } else if(ButtonNum >= 25 && ButtonNum <= 28) {
+        us0 = servoCal[servoCalCh].us0;
+        us180 = servoCal[servoCalCh].us180;
+        if(ButtonNum == 25)      us0 += SERVO_CAL_STEP_US;     // 0 end point +/-
+        else if(ButtonNum == 26) us0 -= SERVO_CAL_STEP_US;
+        else if(ButtonNum == 27) us180 += SERVO_CAL_STEP_US;   // 180 end point +/-
+        else                     us180 -= SERVO_CAL_STEP_US;
+        servoCalibrate(servoCalCh, us0, us180);   // Clamped, effective next frame, kept in NVRAM
+        servoSet(servoCalCh, ButtonNum <= 26 ? 0 : SERVO_DEG_MAX); // Hold the end point being trimmed
+        servoCalShow(servoCalCh);
     }
 }
  
     }   // End of Menu Navigation block
 
-// --- (E) Loop Delay ---  
-// delay_ms(20);  // Optional delay between iterations for UI responsiveness 
+// --- (E) End of Pass ---  
+        TRACE(TR_SUPER);
+        superPoll();                  // Deadlines: renews the watchdog credit only while every task checked in
+        loopWorkUs = elapsedUs(passUs);   // Busy time of this pass (the rest of LOOP_MS is the pacing wait)
+        if (loopWorkUs > loopWorkMaxUs) loopWorkMaxUs = loopWorkUs;
     } //End of the MAIN LOOP  
 } //End of the MAIN FUNCTION  
 
@@ -251,6 +533,7 @@ void screen0(void)
     LCD_setCursor(10, 110);                       // Set cursor to (10,110) for first name  
     LCD_setText1Color(WHITE);                     // Set text color to white for names  
     printf("Ivgeni-Goriatchev");                  // Print first student name  
+    LCD_drawButton(18, 20, 150, 70, 40, 5, BLUE, WHITE, "Diag", 2);  // Draw "Diag" button (clock drift) at (20,150)
 
    
 }  
@@ -264,11 +547,16 @@ void screen1(void)
     LCD_drawButton(3,170,20,100,40,5,BLUE,WHITE,"Project",2); // Draw "Project" button  
     LCD_drawButton(4,20,65,70,40,5,BLUE,WHITE,"Time",2);      // Draw sub-menu "Time" button  
     LCD_drawButton(5,95,65,70,40,5,BLUE,WHITE,"Tempr",2);     // Draw sub-menu "Temperature" button  
+#if I2C_BENCH
+    LCD_drawButton(12,170,65,100,40,5,BLUE,WHITE,"I2C",2);    // Draw "I2C" bench button (bench builds only)
+#endif
     LCD_drawButton(6,20,110,70,40,5,BLUE,WHITE,"Soil",2);      // Draw sub-menu "Soil" button  
     LCD_drawButton(7,95,110,70,40,5,BLUE,WHITE,"Rain",2);     // Draw sub-menu "Rain" button  
     LCD_drawButton(8,170,110,100,40,5,BLUE,WHITE,"Light",2);  // Draw sub-menu "Light" button  
     LCD_drawButton(9, 20,155,70,40,5,BLUE,WHITE,"Pump",2);     // Draw "Pump" button at (20,155)
     LCD_drawButton(10,95,155,70,40,5,BLUE,WHITE,"Servo",2);    // Draw "Servo" button at (95,155)
+    LCD_drawButton(11,170,155,100,40,5,BLUE,WHITE,"Rate",2);   // Draw "Rate" button (sampling statistics) at (170,155)
+    LCD_drawButton(23,275,155,40,40,5,BLUE,WHITE,"C",2);       // "Cal" button: servo calibration screen
     LCD_fillRect(10,200,300,40,BLUE);             // Draw a blue rectangle for result display area at (10,200) size 30040  
     LCD_setCursor(15,215);                        // Position cursor at (15,215) inside result area  
     printf("Result:");                            // Print "Result:" label  
@@ -293,8 +581,121 @@ void screen2(void)
     LCD_print2C(10,160,"Temp", 2, GREEN, BLACK); // Print centered "Temp" label at (10,160)  
     LCD_drawButton(17,65,155,110,30,5,GREEN,WHITE,"+/-",3); // Draw "+/-" button to adjust TEMP_THRESHOLD at (65,155) size 11030  
     LCD_fillRect(185,155,80,30,GREEN);            // Clear temperature threshold display area by drawing a green rectangle  
+    LCD_print2C(10,200,"Date", 2, GREEN, BLACK); // Print centered "Date" label at (10,200)
+    LCD_drawButton(19,65,195,35,30,5,GREEN,WHITE,"D",2);   // Step day
+    LCD_drawButton(20,105,195,35,30,5,GREEN,WHITE,"M",2);  // Step month
+    LCD_drawButton(21,145,195,35,30,5,GREEN,WHITE,"Y",2);  // Step year
+    setupDateShow();
+    LCD_setCursor(200,80);                        // Show the staged values in their fields
+    printf("%d", setupHour);
+    LCD_setCursor(200,120);
+    printf("%d", setupMinute);
+    LCD_setCursor(200,160);
+    printf("%d", setupThreshold);
 }  
 
+// setupDateShow(): Staged date "dd/mm/yy Www" in the Setup date field.
+void setupDateShow(void)
+{
+    U8 d = setupDate, dim = calMonthDays(setupMonth, setupYear);
+    if (d > dim) d = dim;                         // Shown as it will be committed
+    LCD_fillRect(185,195,130,30,GREEN);
+    LCD_setCursor(188,200);
+    printf("%02u/%02u/%02u", (U16)d, (U16)setupMonth, (U16)setupYear);
+}
+
+// setupCommit(): Writes only what was edited on the Setup screen.
+//   - Time and date: one 7-byte burst 0x00..0x06, seconds reset to 00.
+//   - Time only: one 3-byte burst 0x00..0x02 (the running date is kept, so a
+//     midnight that passed while the screen was open is not undone).
+//   - Date only: one 4-byte burst 0x03..0x06 (the running seconds are kept).
+//   - The calendar (calSet) and the day plan follow only a written date.
+//   - Threshold: NVRAM record (NV_THRESHOLD); the LM75 TOS/THYST are reprogrammed.
+//   - On an IC failure the edits stay staged and the idle timeout retries them.
+void setupCommit(void)
+{
+    U8 rtc[7], nv[2], st, d;
+    if (!setupDirty) return;
+    if (setupDirty & (SETUP_TIME | SETUP_DATE))
+    {
+        d = calMonthDays(setupMonth, setupYear);
+        if (setupDate < d) d = setupDate;         // Clamped as calSet() will clamp it
+        rtc[0] = 0x00;                            // 0x00 seconds = 00, CH = 0 (clock runs)
+        rtc[1] = decToBcd(setupMinute);           // 0x01 minutes
+        rtc[2] = decToBcd(setupHour);             // 0x02 hours (24 h)
+        rtc[3] = calWeekday(setupYear, setupMonth, d) + 1; // 0x03 day of week, 1 = Sunday
+        rtc[4] = decToBcd(d);                     // 0x04 date
+        rtc[5] = decToBcd(setupMonth);            // 0x05 month
+        rtc[6] = decToBcd(setupYear);             // 0x06 year
+        if ((setupDirty & (SETUP_TIME | SETUP_DATE)) == (SETUP_TIME | SETUP_DATE))
+            st = writeDS1307Burst(0x00, rtc, 7);
+        else if (setupDirty & SETUP_TIME)
+            st = writeDS1307Burst(0x00, rtc, 3);
+        else
+            st = writeDS1307Burst(0x03, rtc + 3, 4);
+        if (st != I2C_OK) { setupEditTick = loopTicks; return; }
+        if (setupDirty & SETUP_TIME)
+        {
+            hour = setupHour;                     // The RTC now holds exactly these values
+            minute = setupMinute;
+            second = 0;
+            shadowSet((U32)setupHour * 3600 + (U32)setupMinute * 60); // Shadow clock restarts with the RTC second
+        }
+        if (setupDirty & SETUP_DATE)
+        {
+            calSet(setupYear, setupMonth, d);     // Weekday / day of year of the new date
+            planToday();                          // New date -> new day plan
+        }
+        calLastSec = shadowNow();                 // A clock set is not a midnight
+        setupDirty &= ~(SETUP_TIME | SETUP_DATE);
+    }
+    if (setupDirty & SETUP_THR)
+    {
+        nv[0] = setupThreshold;
+        nv[1] = ~setupThreshold;
+        if (writeDS1307Burst(NV_THRESHOLD, nv, 2) != I2C_OK) { setupEditTick = loopTicks; return; }
+        TEMP_THRESHOLD = setupThreshold;
+        lm75AlarmAll(TEMP_THRESHOLD);             // Reprogram TOS/THYST of every LM75 to the new threshold
+        policy[SENSOR_TEMP].threshold = TEMP_THRESHOLD; // Sampling policy follows the new decision point
+        setupDirty &= ~SETUP_THR;
+    }
+}
+
+// thresholdLoad(): TEMP_THRESHOLD from NVRAM; a blank or corrupt record keeps the default.
+void thresholdLoad(void)
+{
+    U8 nv[2];
+    if (readDS1307Burst(NV_THRESHOLD, nv, 2) == I2C_OK &&
+        nv[1] == (U8)~nv[0] && nv[0] >= 20 && nv[0] <= 30)
+        TEMP_THRESHOLD = nv[0];
+}
+
+/*
+ * touchDebounce(): Turns the raw button under the finger into button events.
+ * Parameters:
+ *   btn - ButtonTouch() result of this pass (0 = no button touched)
+ * Returns:
+ *   btn on a new press or an auto-repeat, 0 otherwise
+ */
+S16 touchDebounce(S16 btn)
+{
+    if (btn != touchHeld)                        // New press (or release)
+    {
+        touchHeld = btn;
+        touchMs = clockNow();
+        touchRepeating = 0;
+        return btn;
+    }
+    if (btn && TOUCH_REPEATS(btn) &&
+        elapsed(touchMs) >= (touchRepeating ? TOUCH_RATE_MS : TOUCH_REPEAT_MS))
+    {
+        touchMs = clockNow();
+        touchRepeating = 1;
+        return btn;                              // Held: auto-repeat
+    }
+    return 0;
+}
+
 // screen3(): Draws the "Project" screen for real-time operation.  
 void screen3(void)  
 {  
@@ -302,76 +703,219 @@ void screen3(void)
     LCD_drawButton(1,20,20,70,40,5,RED,WHITE,"Check",2);    // Draw "Check" button in red/white  
     LCD_drawButton(2,95,20,70,40,5,RED,WHITE,"Setup",2);    // Draw "Setup" button in red/white  
     LCD_drawButton(3,170,20,100,40,5,RED,WHITE,"Project",2); // Draw "Project" button in red/white  
+    LCD_drawButton(22,275,20,40,40,5,RED,WHITE,"?",2);        // "Why" button: decision trace screen
+    healthIconsReset();                          // Sensor status icons are drawn by runProject()
 } 
+
+// screen4(): Draws the "Diag" screen (clock drift measurement).
+void screen4(void)
+{
+    LCD_fillScreen(BLACK);                       // Clear the screen (fill with black)
+    LCD_drawButton(1,20,20,70,40,5,BLUE,WHITE,"Check",2);    // Top menu buttons
+    LCD_drawButton(2,95,20,70,40,5,BLUE,WHITE,"Setup",2);
+    LCD_drawButton(3,170,20,100,40,5,BLUE,WHITE,"Project",2);
+    diagShow();
+}
+
+// screen5(): Draws the "Why" screen (decision trace, irrigation keeps running).
+void screen5(void)
+{
+    LCD_fillScreen(BLACK);                       // Clear the screen (fill with black)
+    LCD_drawButton(1,20,20,70,40,5,RED,WHITE,"Check",2);     // Top menu buttons ("Project" returns)
+    LCD_drawButton(2,95,20,70,40,5,RED,WHITE,"Setup",2);
+    LCD_drawButton(3,170,20,100,40,5,RED,WHITE,"Project",2);
+    whyShow();
+}
+
+// screen6(): Draws the "Cal" screen (servo end points, pump off).
+void screen6(void)
+{
+    LCD_fillScreen(BLACK);                       // Clear the screen (fill with black)
+    LCD_drawButton(1,20,20,70,40,5,BLUE,WHITE,"Check",2);    // Top menu buttons (leaving parks the servo)
+    LCD_drawButton(2,95,20,70,40,5,BLUE,WHITE,"Setup",2);
+    LCD_drawButton(3,170,20,100,40,5,BLUE,WHITE,"Project",2);
+    LCD_print2C(10,80,"Ch",2,BLUE,BLACK);        // Channel: next one on each press
+    LCD_drawButton(24,65,75,110,30,5,BLUE,WHITE,"Next",2);
+    LCD_print2C(10,120,"0",2,BLUE,BLACK);        // Pulse width at 0
+    LCD_drawButton(25,65,115,50,30,5,BLUE,WHITE,"+",2);
+    LCD_drawButton(26,125,115,50,30,5,BLUE,WHITE,"-",2);
+    LCD_print2C(10,160,"180",2,BLUE,BLACK);      // Pulse width at 180
+    LCD_drawButton(27,65,155,50,30,5,BLUE,WHITE,"+",2);
+    LCD_drawButton(28,125,155,50,30,5,BLUE,WHITE,"-",2);
+    servoCalShow(0);
+}
+
+// servoCalShow(): Channel number and its end points (s) in the Cal screen fields.
+void servoCalShow(U8 ch)
+{
+    LCD_fillRect(185,75,80,30,BLUE);
+    LCD_setCursor(200,80);
+    printf("%u", (U16)ch);
+    LCD_fillRect(185,115,80,30,BLUE);
+    LCD_setCursor(190,120);
+    printf("%u", servoCal[ch].us0);
+    LCD_fillRect(185,155,80,30,BLUE);
+    LCD_setCursor(190,160);
+    printf("%u", servoCal[ch].us180);
+}
+
+// whyShow(): Decision trace (see decision_trace.h):
+//   Now    reason of the latest runProject() decision and since when
+//   Table  per reason today: transitions into it, minutes spent in it
+//   Last   the 4 latest transitions (HH:MM reason), newest first
+void whyShow(void)
+{
+    U8 i;
+    WhyEvent xdata *e;
+    LCD_setText2Color(WHITE, BLACK);
+    LCD_setCursor(10,70);
+    printf("Now %-5s %4um   (n min) ", whyName[whyNow], (U16)(elapsed(whySince) / 60000UL));
+    for (i = 0; i < WHY_COUNT; i++)              // Two reasons per line: name, count, minutes
+    {
+        LCD_setCursor(i & 1 ? 162 : 10, 92 + (i >> 1) * 20);
+        printf("%-5s%3u%4u", whyName[i], whyCount[i], whyMinutes(i));
+    }
+    for (i = 0; i < 4; i++)                      // Two transitions per line, newest first
+    {
+        LCD_setCursor(i & 1 ? 162 : 10, 196 + (i >> 1) * 20);
+        if (i >= whyLogged)
+        {
+            printf("            ");
+            continue;
+        }
+        e = whyEvent(i);
+        printf("%02u:%02u %-5s ", (U16)(e->sec / 3600), (U16)(e->sec / 60 % 60), whyName[e->reason]);
+    }
+}
+
+// diagShow(): Drift tracker values (see shadow_clock.h):
+//   Trim   smoothed Timer2 -> RTC correction and number of windows behind it
+//   Last   result of the last window and its length
+//   Offset shadow - RTC at the last edge, write-backs to the DS1307
+//   State  edge hunt in progress, or time to the next one
+//   Sun    today's sunrise-sunset (solar.h) and day of the year
+//   Dl     deadline misses L/T/A (supervisor.h), last missed task with its age,
+//          watchdog resets (* = this boot followed one)
+void diagShow(void)
+{
+    U32 t = clockNow() - driftAnchorMs;
+    U8 m = superLastMiss;
+    LCD_setText2Color(WHITE, BLACK);
+    LCD_setCursor(10,80);
+    printf("Trim  %+6d ppm n%-3u ", shadowTrimPpm, (U16)driftWindows);
+    LCD_setCursor(10,110);
+    printf("Last  %+6d ppm %5lus ", driftLastPpm, driftLastWindow);
+    LCD_setCursor(10,140);
+    printf("Offs  %+6d s   wb%-4u ", driftOffset, driftWritebacks);
+    LCD_setCursor(10,170);
+    if (driftHunting)
+        printf("Sync  edge hunt        ");
+    else
+        printf("Sync  next in %5lus   ", t >= DRIFT_WINDOW_S * 1000UL ? 0UL : DRIFT_WINDOW_S - t / 1000UL);
+    LCD_setCursor(10,200);
+    if (solarRise == SOLAR_NONE)
+        printf("Sun   none       d%-3u ", calYday);
+    else
+        printf("Sun   %02d:%02d-%02d:%02d d%-3u ", solarRise / 60, solarRise % 60,
+               solarSet / 60, solarSet % 60, calYday);
+    LCD_setCursor(10,224);
+    if (m >= TASK_COUNT)
+        printf("Dl %u/%u/%u none     ", task[TASK_LOOP].misses, task[TASK_TEMP].misses, task[TASK_ADC].misses);
+    else                                    // Age only for a miss of this boot (else: before the reset)
+        printf("Dl %u/%u/%u %c%5lus ", task[TASK_LOOP].misses, task[TASK_TEMP].misses, task[TASK_ADC].misses,
+               taskLetter[m], task[m].misses ? (clockNow() - task[m].lastMissMs) / 1000UL : 0UL);
+    printf("w%u%c ", (U16)superWdtResets, superWdtReset ? '*' : ' ');
+}
+
 // --------------------------------------------------------------------  
-// runProject(): Implements the real-time project logic (irrigation control)  
+// projectShow(): Real-time sensor values on the Project screen  
 // --------------------------------------------------------------------  
-void runProject(void)  
-{  
+void projectShow(void)
+{
     // Set LCD text color (foreground WHITE on background BLACK)  
     LCD_setText2Color(WHITE, BLACK);  
     // Display current time label and value  
     LCD_setCursor(20,70);                // Position cursor for "Time:" label  
     printf("Time:");                     // Print "Time:"  
     printTime(hour, minute, second);     // Print formatted time (calls helper to format HH:MM:SS)     
+    printf(" %s %02u/%02u", wdayName[calWday], (U16)calDate, (U16)calMonth); // Weekday and date
     // Display temperature  
     LCD_setCursor(20,100);               // Position cursor for temperature line  
     printf("Temp=%.2f C  (Th=%d)", temp, TEMP_THRESHOLD); // Print temperature and threshold  
     // Display sensor readings for rain, soil, and light  
     LCD_setCursor(20,130);               // Position cursor for rain  
-    printf("Rain=%d%%", rain);           // Print rain sensor percentage  
+    printf("Rain=%d%% D%u%s ", rain, (U16)rainDelay, rainSkipping ? " skip" : "     "); // Reading, rain delay  
     LCD_setCursor(20,160);               // Position cursor for soil  
     printf("Soil=%d%%", soil);           // Print soil moisture percentage  
+    LCD_setCursor(160,160);              // Flow rate (L/min)
+    printf("Q=%u.%uL/m ", flowRate / 1000, flowRate % 1000 / 100);
     LCD_setCursor(20,190);               // Position cursor for light  
     printf("Light=%d%%", light);         // Print light sensor percentage  
+    LCD_setCursor(160,190);              // Volume in this window (L)
+    printf("V=%u.%uL ", flowDl(flowWindow) / 10, flowDl(flowWindow) % 10);
+    healthIcons(20,220);                 // Sensor status icons (only the ones that changed)  
+}
+
+// --------------------------------------------------------------------  
+// runProject(): Implements the real-time project logic (irrigation control)  
+// Every outcome is recorded as a reason code (decision_trace.h): WHY() costs two
+// compares unless the reason changes.
+// --------------------------------------------------------------------  
+void runProject(void)  
+{  
     // ---------------- Combined Irrigation Conditions ----------------  
     // Conditions to activate irrigation:  
-    //   1. Soil sensor reading must be at least SOIL_THRESHOLD (i.e., soil is dry).  
-    //   2. Current time must be within the allowed windows: 04:00-08:00 or 19:00-22:00.  
+    //   1. Soil sensor reading must be at least SOIL_THRESHOLD (i.e., soil is dry) -> soilDry from the ADC0 window ISR.  
+    //   2. Current time must be within one of today's windows (day plan, calendar.h).  
     //   3. Ambient light sensor reading must be below LIGHT_THRESHOLD (i.e., not too bright).  
-    //   4. Rain sensor reading must be at least RAIN_THRESHOLD (i.e., no significant rain).  
-    //   5. Temperature must be below TEMP_THRESHOLD.  
+    //   4. Rain sensor reading must be at least RAIN_THRESHOLD (i.e., no significant rain),
+    //      and the window must not be skipped by a rain delay (rain.h).  
+    //   5. The window's water volume must be below FLOW_TARGET_ML (flow.h).  
+    //   6. Temperature must be below TEMP_THRESHOLD at every LM75 (shared O.S. pin released).  
+    // A faulty sensor (sensor_health.h) is left out of its check, or stops watering
+    // when its fail-safe policy is FAIL_BLOCK.
 // Check if soil is dry enough
-if (soil < SOIL_THRESHOLD) {
+if (healthOk(SENSOR_SOIL) ? !soilDry : healthBlocks(SENSOR_SOIL)) { // soilDry: updated only on window crossings
     Relay_Off();           // Soil is still moist  turn off the pump
+    WHY(WHY_SOIL);
     return;                // Exit function early  no need to evaluate further conditions
 }
-if (!(((hour >= 4) && (hour < 8)) || ((hour >= 19) && (hour < 22)))) {   // Current time must be within the allowed windows: 04:00-08:00 or 19:00-22:00.
+if (!planAllows(hour * 60 + minute)) {   // Current time must be within one of today's windows (plan cached at midnight)
     Relay_Off();           // Time is outside allowed irrigation window  disable pump
+    WHY(WHY_TIME);
     return;                // Skip irrigation logic
 }
-if (light >= LIGHT_THRESHOLD) {
+if (healthOk(SENSOR_LIGHT) ? light >= LIGHT_THRESHOLD : healthBlocks(SENSOR_LIGHT)) {
     Relay_Off();           // Ambient light is too strong  cancel irrigation
+    WHY(WHY_LIGHT);
     return;
 }
-if (rain < RAIN_THRESHOLD) {
+if (healthOk(SENSOR_RAIN) ? rain < RAIN_THRESHOLD : healthBlocks(SENSOR_RAIN)) {
     Relay_Off();           // Rain has been detected  skip watering
+    WHY(WHY_RAIN);
+    return;
+}
+if (rainSkipping) {
+    Relay_Off();           // Window skipped: enough rain fell before it  rain delay
+    WHY(WHY_DELAY);
+    return;
+}
+if (flowDone) {
+    Relay_Off();           // This window's water volume has been delivered
+    WHY(WHY_FLOW);
     return;
 }
-if (temp >= TEMP_THRESHOLD) {
+if (healthOk(SENSOR_TEMP) ? !LM75_OS : healthBlocks(SENSOR_TEMP)) { // O.S. active-low (wired-OR): the hottest LM75 reports T >= TEMP_THRESHOLD (set via TOS)
     Relay_Off();           // Temperature too high  skip irrigation
+    WHY(WHY_TEMP);
     return;
 }
 
 // All conditions met  activate irrigation
 Relay_On();                // Enable pump via relay control
+WHY(WHY_WATER);
 
-// Gradually sweep the servo angle
-// Note: 30 s step = 304 = 120 PCA ticks (~1.67% of the 6002400 s span; ~0.18% duty change per 16.384 ms frame)
-if (directionUp) {                    // State flag: 1 = sweep up, 0 = sweep down
-    angle += 30;                      // Step +30 s (smooth increment)
-    if (angle >= 2400) {              // Upper bound check (max 2.4 ms)
-        angle = 2400;                 // Clamp to max safe width
-        directionUp = 0;              // Flip direction at the top end
-    }
-} else {                              // directionUp == 0 -> sweep down
-    angle -= 30;                      // Step -30 s (smooth decrement)
-    if (angle <= 600) {               // Lower bound check (min 0.6 ms)
-        angle = 600;                  // Clamp to min safe width
-        directionUp = 1;              // Flip direction at the bottom end
-    }
-}
-pulse(angle);      // Load PCA compare with new pulse width (s) Update PWM HIGH time: writes 16-bit compare (CPL0/CPH0); PCA ends HIGH at match
-delay_ms(20);      // ~20 ms between steps -> natural servo motion
+// The servos sweep while the pump runs: servoSweepAll(Relay) in the main loop,
+// stepped by the PCA frame interrupt (servo.h)
 }  
  
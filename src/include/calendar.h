@@ -0,0 +1,192 @@
+// ================== calendar.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Date from the DS1307 and the weekday-aware watering plan of the current day.
+// ----------------------------------------------------------
+// [1] Calendar:
+//     -> calLoad(): one burst read of 0x00..0x06 at boot (time, weekday, date, year)
+//     -> Years 2000..2099 (DS1307 00..99): every 4th year is a leap year
+//     -> Weekday and day of year are computed from the date; register 0x03 is
+//        only written (1 = Sunday), never trusted
+//     -> calTick(): the shadow clock passing midnight advances the date in RAM
+//        (the DS1307 rolls over on its own)
+// [2] Schedule:
+//     -> Watering windows (site_config.h): each edge is a clock time or an offset
+//        from sunrise/sunset, a per-weekday window mask and an odd/even-date
+//        restriction (WATER_PARITY)
+// [3] Day Plan:
+//     -> planToday(): solves today's sunrise/sunset (solar.h) and resolves schedule
+//        + restriction for the current date into planOpen[]/planClose[] (minutes of
+//        the day); runs at boot, at midnight and after a date change
+//     -> planAllows(): the only check left in runProject (at most PLAN_MAX compares)
+
+// ---------- [1] Calendar ----------
+U8  calYear  = 0;               // 0..99 -> 2000..2099
+U8  calMonth = 1;               // 1..12
+U8  calDate  = 1;               // 1..31
+U8  calWday  = 6;               // 0 = Sunday .. 6 = Saturday (01/01/2000 was a Saturday)
+U16 calYday  = 1;               // Day of the year, 1..366
+U32 calLastSec = 0;             // Shadow time of day at the previous calTick()
+
+char code wdayName[7][4] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+U8   code monthDays[12]  = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+U16  code monthStart[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+
+// calMonthDays(): Length of a month (1..12) in the year 20yy.
+U8 calMonthDays(U8 month, U8 year)
+{
+    if (month == 2 && (year & 3) == 0) return 29;
+    return monthDays[month - 1];
+}
+
+// calWeekday(): 0 = Sunday .. 6 = Saturday, from the days since 01/01/2000.
+U8 calWeekday(U8 year, U8 month, U8 date)
+{
+    U16 days = (U16)year * 365 + (year + 3) / 4           // Whole years (+1 per leap year before)
+             + monthStart[month - 1] + date - 1;
+    if (month > 2 && (year & 3) == 0) days++;              // Past 29 Feb of a leap year
+    return (U8)((days + 6) % 7);
+}
+
+// calSet(): Sets the date (date clamped to the month), weekday and day of year.
+void calSet(U8 year, U8 month, U8 date)
+{
+    if (year > 99) year = 0;
+    if (month < 1 || month > 12) month = 1;
+    if (date < 1) date = 1;
+    if (date > calMonthDays(month, year)) date = calMonthDays(month, year);
+    calYear = year;
+    calMonth = month;
+    calDate = date;
+    calWday = calWeekday(year, month, date);
+    calYday = monthStart[month - 1] + date;
+    if (month > 2 && (year & 3) == 0) calYday++;
+}
+
+// calNextDay(): Midnight: next date, with month/year rollover.
+void calNextDay(void)
+{
+    U8 d = calDate + 1, m = calMonth, y = calYear;
+    if (d > calMonthDays(m, y))
+    {
+        d = 1;
+        if (++m > 12)
+        {
+            m = 1;
+            y = (y + 1) % 100;
+        }
+    }
+    calSet(y, m, d);
+}
+
+/*
+ * calLoad(): Reads the DS1307 clock registers 0x00..0x06 in one burst (r[7], raw BCD).
+ *   - On I2C_OK the date is taken over (implausible values fall back to 01/01);
+ *     r[0..2] are left for the shadow clock.
+ * Returns:
+ *   I2C_OK, or the status of the failed read (date stays 01/01/2000)
+ */
+U8 calLoad(U8 *r)
+{
+    U8 st = readDS1307Burst(0x00, r, 7);
+    if (st == I2C_OK)
+        calSet(bcdToDec(r[6]), bcdToDec(r[5] & 0x1F), bcdToDec(r[4] & 0x3F));
+    return st;
+}
+
+// ---------- [2] Schedule ----------
+// Window n is enabled on a weekday when bit n of weekWindows[] is set.
+// WATER_PARITY restricts watering to odd or even dates (day of the month), as in
+// municipal odd/even restrictions; it applies on top of the weekday mask.
+#define PLAN_MAX        2       // Watering windows per day
+#define PARITY_ANY      0       // Every date
+#define PARITY_ODD      1       // 1st, 3rd, ... 31st only
+#define PARITY_EVEN     2       // 2nd, 4th, ... 30th only
+#define WATER_PARITY    PARITY_ANY
+
+typedef struct
+{
+    U8  openRef;                // WIN_CLOCK / WIN_SUNRISE / WIN_SUNSET
+    S16 open;                   // First minute of the window (minutes, relative to openRef)
+    U8  closeRef;
+    S16 close;                  // First minute after the window
+} WaterWindow;
+
+WaterWindow code waterWindow[PLAN_MAX] = {
+    { WIN0_OPEN_REF, WIN0_OPEN, WIN0_CLOSE_REF, WIN0_CLOSE },   // Window 0: morning
+    { WIN1_OPEN_REF, WIN1_OPEN, WIN1_CLOSE_REF, WIN1_CLOSE }    // Window 1: evening
+};
+
+//                            Sun   Mon   Tue   Wed   Thu   Fri   Sat
+U8 code weekWindows[7]   = { 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03 };
+
+// ---------- [3] Day Plan ----------
+U16 planOpen[PLAN_MAX];         // Today's windows, resolved by planToday()
+U16 planClose[PLAN_MAX];
+U8  planCount = 0;              // 0 = no watering today
+
+/*
+ * planEdge(): One window edge in minutes of today, clamped to 0..1440.
+ * Returns:
+ *   -1 if the edge is sun-relative and the sun does not rise/set today
+ */
+S16 planEdge(U8 ref, S16 offset)
+{
+    S16 base = 0;
+    if (ref == WIN_SUNRISE) base = solarRise;
+    else if (ref == WIN_SUNSET) base = solarSet;
+    if (ref != WIN_CLOCK && base == SOLAR_NONE) return -1;
+    base += offset;
+    if (base < 0) base = 0;         // A window does not reach into yesterday or tomorrow
+    if (base > 1440) base = 1440;
+    return base;
+}
+
+void planToday(void)
+{
+    U8 i, mask = weekWindows[calWday];
+    S16 open, close;
+#if WATER_PARITY == PARITY_ODD
+    if (!(calDate & 1)) mask = 0;
+#elif WATER_PARITY == PARITY_EVEN
+    if (calDate & 1) mask = 0;
+#endif
+    solarDay(calYday);              // Once per day: the only call into the solver
+    planCount = 0;
+    for (i = 0; i < PLAN_MAX; i++)
+    {
+        if (!(mask & (1 << i))) continue;
+        open  = planEdge(waterWindow[i].openRef,  waterWindow[i].open);
+        close = planEdge(waterWindow[i].closeRef, waterWindow[i].close);
+        if (open < 0 || close <= open) continue;    // No sun today, or an empty window
+        planOpen[planCount]  = (U16)open;
+        planClose[planCount] = (U16)close;
+        planCount++;
+    }
+}
+
+// planAllows(): 1 if the minute of the day lies inside one of today's windows.
+bit planAllows(U16 minuteOfDay)
+{
+    U8 i;
+    for (i = 0; i < planCount; i++)
+        if (minuteOfDay >= planOpen[i] && minuteOfDay < planClose[i])
+            return 1;
+    return 0;
+}
+
+/*
+ * calTick(): Once per main-loop pass with the shadow time of day.
+ *   A drop of more than half a day is midnight (a clock set backwards in Setup is
+ *   a small drop and goes through calSet() instead).
+ */
+void calTick(U32 daySec)
+{
+    if (daySec < calLastSec && calLastSec - daySec > 43200UL)
+    {
+        calNextDay();
+        planToday();                // The only place the plan changes during normal running
+    }
+    calLastSec = daySec;
+}
@@ -0,0 +1,115 @@
+// ================== decision_trace.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Decision trace: why runProject() switched the pump on or off, per day and over
+// the last transitions.
+// ----------------------------------------------------------
+// [1] Reason Codes:
+//     -> Every runProject() evaluation ends in exactly one code: WHY_WATER (pump on)
+//        or the check that kept it off, in the order runProject() tests them
+//     -> WHY_OFF: project mode left (Check / Setup screen)
+// [2] Hot Path:
+//     -> WHY(r) compares the day and the code with the current ones: one U16 and one
+//        U8 compare per evaluation; whyNewDay() runs once per day, whyChange() only
+//        on a transition
+// [3] Daily Counters:
+//     -> Per reason: transitions into it and the time spent in it (ms) since
+//        midnight. A reason that holds across midnight is credited from 00:00 but
+//        is not a transition: it is neither counted nor logged again.
+//        The running reason's time is added when it is read (whyMinutes())
+// [4] Transition Ring:
+//     -> The last WHY_RING transitions with their time of day (shadow clock),
+//        shown on the "Why" screen next to the daily table
+
+// ---------- [1] Reason Codes ----------
+#define WHY_WATER       0       // All checks passed: pump on
+#define WHY_SOIL        1       // Soil still moist (or soil sensor blocking)
+#define WHY_TIME        2       // Outside today's watering windows
+#define WHY_LIGHT       3       // Too bright
+#define WHY_RAIN        4       // Raining now
+#define WHY_DELAY       5       // Window skipped by the rain delay
+#define WHY_FLOW        6       // Window volume delivered
+#define WHY_TEMP        7       // Too hot at an LM75
+#define WHY_OFF         8       // Not in project mode
+#define WHY_COUNT       9
+
+char code whyName[WHY_COUNT][6] = {
+    "Water", "Soil", "Time", "Light", "Rain", "Delay", "Flow", "Temp", "Off"
+};
+
+// ---------- [3] Daily Counters ----------
+U8  whyNow = WHY_OFF;           // Reason of the latest evaluation
+U16 whyDay = 0;                 // calYday the counters belong to (0 = none yet)
+U32 whySince = 0;               // clockNow() when whyNow began (or midnight)
+U16 xdata whyCount[WHY_COUNT];  // Transitions into each reason today
+U32 xdata whyMs[WHY_COUNT];     // Time in each reason today, up to whySince (ms)
+
+// ---------- [4] Transition Ring ----------
+#define WHY_RING        8       // Transitions kept (power of 2)
+
+typedef struct
+{
+    U8  reason;                 // New reason
+    U32 sec;                    // Time of day it began (s)
+} WhyEvent;
+
+WhyEvent xdata whyRing[WHY_RING];
+U8 whyHead = 0;                 // Next slot to write
+U8 whyLogged = 0;               // Valid entries (saturates at WHY_RING)
+
+// ---------- [3] Day Rollover ----------
+/*
+ * whyNewDay(): Clears the counters for a new calYday (WHY() only). The reason
+ * that was running carries over: it is credited from midnight, not from when it
+ * began, and gets no count or ring entry of its own.
+ */
+void whyNewDay(void)
+{
+    U32 now = clockNow();
+    U32 sec = shadowNow();
+    U8 i;
+    for (i = 0; i < WHY_COUNT; i++)
+    {
+        whyCount[i] = 0;
+        whyMs[i] = 0;
+    }
+    if (whyDay && now - whySince > sec * 1000UL)
+        whySince = now - sec * 1000UL;          // Running reason counts from 00:00
+    whyDay = calYday;
+}
+
+// ---------- [2] + [3] + [4] Transition ----------
+// whyChange(): Closes the running reason and starts `reason` (WHY() only).
+void whyChange(U8 reason)
+{
+    U32 now = clockNow();
+    U32 sec = shadowNow();
+    whyMs[whyNow] += now - whySince;
+    whySince = now;
+    whyNow = reason;
+    whyCount[reason]++;
+    whyRing[whyHead].reason = reason;
+    whyRing[whyHead].sec = sec;
+    whyHead = (whyHead + 1) & (WHY_RING - 1);
+    if (whyLogged < WHY_RING) whyLogged++;
+}
+
+// Hot path: records an evaluation's reason; only a new day or a new reason costs more.
+#define WHY(r)          { if (calYday != whyDay) whyNewDay(); if ((r) != whyNow) whyChange(r); }
+
+// ---------- [3] Daily Counters ----------
+// whyMinutes(): Minutes spent in a reason today, including the running one.
+U16 whyMinutes(U8 reason)
+{
+    U32 ms = whyMs[reason];
+    if (reason == whyNow) ms += elapsed(whySince);
+    return (U16)(ms / 60000UL);
+}
+
+// ---------- [4] Transition Ring ----------
+// whyEvent(): The n-th most recent transition (0 = latest; n < whyLogged).
+WhyEvent xdata *whyEvent(U8 n)
+{
+    return &whyRing[(whyHead - 1 - n) & (WHY_RING - 1)];
+}
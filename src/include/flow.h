@@ -0,0 +1,203 @@
+// ================== flow.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Flow meter: water volume per window and per day from a hall-effect flow sensor.
+// ----------------------------------------------------------
+// [1] Pulse Counting:
+//     -> Timer0 in 16-bit counter mode on the T0 pin (P0.1, Init_Device step 12):
+//        the hardware counts every pulse, no interrupt and no CPU time per pulse
+//     -> flowPoll() (once per loop) adds the counter difference since the previous
+//        poll; the counter laps after 65536 pulses (minutes at the sensor's top
+//        rate), far longer than any loop pass
+// [2] Rate and Volume (fixed point):
+//     -> Volumes are kept in pulses and converted with FLOW_PULSES_PER_L
+//        (site_config.h) only where mL are needed: flowMl(), integer arithmetic
+//     -> flowRate: mL/min averaged over FLOW_RATE_MS
+// [3] Volume per Window:
+//     -> flowWindowTick(): the window volume restarts at 0 when a window opens;
+//        FLOW_TARGET_ML reached -> flowDone, runProject() keeps the pump off for
+//        the rest of the window
+//     -> The window volume, flowDone and the in-window flag are part of the NVRAM
+//        record: a reset inside a window continues the same budget instead of
+//        opening a new one (saved when the window opens, every FLOW_WIN_SAVE_DL of
+//        window volume and when the target is reached, so each reset can add at
+//        most that much). A unit that is off until the next window opens counts
+//        it as the same window (planAllows() gives no window number).
+// [4] Daily Totals:
+//     -> Today's and yesterday's volume (0.1 L) in DS1307 NVRAM (NV_FLOW): written
+//        at most once per FLOW_SAVE_MS while the total grows, when a window closes
+//        and at midnight; restored at boot (at most 0.1 L is lost on a reset)
+
+// ---------- [1] Pulse Counting ----------
+U16 flowLast = 0;               // Timer0 count at the previous flowPoll()
+
+// flowCount(): Reads the running Timer0 counter (TL0 carry into TH0 between the reads -> retry).
+U16 flowCount(void)
+{
+    U8 hi, lo;
+    do {
+        hi = TH0;
+        lo = TL0;
+    } while (hi != TH0);
+    return ((U16)hi << 8) | lo;
+}
+
+// ---------- [2] Rate and Volume ----------
+#define FLOW_RATE_MS    2000    // Rate averaging period (~900 pulses at 60 L/min)
+#define FLOW_SAVE_MS    60000UL // Shortest interval between two NVRAM writes
+
+U32 flowToday = 0;              // Pulses since midnight
+U32 flowYesterday = 0;          // Pulses of the previous day
+U32 flowWindow = 0;             // Pulses since the current (or last) window opened
+U16 flowRatePulses = 0;         // Pulses in the running rate period
+U32 flowRateMs = 0;             // clockNow() at the start of the rate period
+U16 flowRate = 0;               // Flow over the last rate period (mL/min)
+U16 flowDay = 0;                // calYday that flowToday belongs to
+U16 flowDelta = 0;              // Pulses counted by the last flowPoll() (sector water, servo.h)
+bit flowDone = 0;               // 1 = FLOW_TARGET_ML delivered in the current window
+bit flowInWindow = 0;           // Previous flowWindowTick() input (restored from NVRAM)
+
+// flowMl(): Pulses -> mL (split so pulses  1000 cannot overflow).
+U32 flowMl(U32 pulses)
+{
+    return pulses / FLOW_PULSES_PER_L * 1000UL
+         + pulses % FLOW_PULSES_PER_L * 1000UL / FLOW_PULSES_PER_L;
+}
+
+// flowDl(): Pulses -> 0.1 L (saturating at 6553.5 L), the display/NVRAM unit.
+U16 flowDl(U32 pulses)
+{
+    U32 dl = flowMl(pulses) / 100;
+    return dl > 0xFFFF ? 0xFFFF : (U16)dl;
+}
+
+// ---------- [4] Daily Totals ----------
+#define NV_FLOW_LEN     11      // Magic, day, today, yesterday, window (LSB/MSB each), flags, checksum
+#define NV_FLOW_MAGIC   0x60    // (0x5F: 8-byte record without the window state)
+#define NV_FLOW_IN      0x01    // Flags: inside a window
+#define NV_FLOW_DONE    0x02    //        window target reached
+#define FLOW_WIN_SAVE_DL 10     // Window volume between two saves inside a window (0.1 L)
+
+U16 flowSaved = 0;              // flowToday (0.1 L) at the last NVRAM write
+U16 flowWinSaved = 0;           // flowWindow (0.1 L) at the last NVRAM write
+U32 flowSaveMs = 0;             // clockNow() of the last NVRAM write
+
+U8 nvFlowSum(U8 *b)
+{
+    U8 i, sum = 0;
+    for (i = 0; i < NV_FLOW_LEN - 1; i++) sum += b[i];
+    return (U8)~sum;
+}
+
+void flowSave(void)
+{
+    U8 b[NV_FLOW_LEN];
+    U16 y = flowDl(flowYesterday);
+    flowSaved = flowDl(flowToday);
+    flowWinSaved = flowDl(flowWindow);
+    flowSaveMs = clockNow();
+    b[0] = NV_FLOW_MAGIC;
+    b[1] = (U8)flowDay;
+    b[2] = (U8)(flowDay >> 8);
+    b[3] = (U8)flowSaved;
+    b[4] = (U8)(flowSaved >> 8);
+    b[5] = (U8)y;
+    b[6] = (U8)(y >> 8);
+    b[7] = (U8)flowWinSaved;
+    b[8] = (U8)(flowWinSaved >> 8);
+    b[9] = (flowInWindow ? NV_FLOW_IN : 0) | (flowDone ? NV_FLOW_DONE : 0);
+    b[10] = nvFlowSum(b);
+    writeDS1307Burst(NV_FLOW, b, NV_FLOW_LEN);
+}
+
+/*
+ * flowLoad(): Restores the daily totals at boot (call after the calendar is set).
+ * A record of today is restored as is, window state included; a record of
+ * yesterday becomes yesterday's total; anything older (or blank/corrupt NVRAM)
+ * starts both at 0 outside any window.
+ */
+void flowLoad(void)
+{
+    U8 b[NV_FLOW_LEN];
+    U16 day;
+    flowLast = flowCount();
+    flowRateMs = flowSaveMs = clockNow();
+    flowDay = calYday;
+    if (readDS1307Burst(NV_FLOW, b, NV_FLOW_LEN) != I2C_OK) return;
+    if (b[0] != NV_FLOW_MAGIC || b[NV_FLOW_LEN - 1] != nvFlowSum(b)) return;
+    day = ((U16)b[2] << 8) | b[1];
+    if (day == calYday)
+    {
+        flowToday = (((U16)b[4] << 8) | b[3]) * (U32)FLOW_PULSES_PER_L / 10;
+        flowYesterday = (((U16)b[6] << 8) | b[5]) * (U32)FLOW_PULSES_PER_L / 10;
+        flowWindow = (((U16)b[8] << 8) | b[7]) * (U32)FLOW_PULSES_PER_L / 10;
+        flowInWindow = (b[9] & NV_FLOW_IN) ? 1 : 0;     // Reset inside a window: same budget
+        flowDone = (b[9] & NV_FLOW_DONE) ? 1 : 0;
+    }
+    else if (day + 1 == calYday || (calYday == 1 && day >= 365))
+        flowYesterday = (((U16)b[4] << 8) | b[3]) * (U32)FLOW_PULSES_PER_L / 10;
+    flowSaved = flowDl(flowToday);
+    flowWinSaved = flowDl(flowWindow);
+}
+
+// ---------- [1] + [2] + [3] Polling ----------
+/*
+ * flowPoll(): Once per main-loop pass, after calTick() and flowWindowTick().
+ * Accumulates the new pulses, rolls the daily totals over at midnight, updates
+ * the rate and flags the window target.
+ */
+void flowPoll(void)
+{
+    U16 c = flowCount();
+    U16 d = c - flowLast;               // Counter difference, correct across a wrap
+    U32 dt;
+    flowLast = c;
+    flowDelta = d;
+    if (calYday != flowDay)             // Midnight (or a new date from the Setup screen)
+    {
+        flowYesterday = flowToday;
+        flowToday = 0;
+        flowDay = calYday;
+        flowSave();
+    }
+    flowToday += d;
+    flowWindow += d;
+    flowRatePulses += d;
+    dt = elapsed(flowRateMs);
+    if (dt >= FLOW_RATE_MS)
+    {
+        flowRate = (U16)(flowMl(flowRatePulses) * 60000UL / dt);   // mL per period -> mL/min
+        flowRatePulses = 0;
+        flowRateMs += dt;
+    }
+    if (FLOW_TARGET_ML && flowInWindow && !flowDone && flowMl(flowWindow) >= FLOW_TARGET_ML)
+    {
+        flowDone = 1;
+        flowSave();                     // A reset must not reopen the budget
+    }
+    else if (flowInWindow && (U16)(flowDl(flowWindow) - flowWinSaved) >= FLOW_WIN_SAVE_DL)
+        flowSave();                     // Window progress survives a reset
+    else if (elapsed(flowSaveMs) >= FLOW_SAVE_MS && flowDl(flowToday) != flowSaved)
+        flowSave();
+}
+
+// ---------- [3] Volume per Window ----------
+/*
+ * flowWindowTick(): Once per main-loop pass.
+ * Parameters:
+ *   inWindow - 1 while the time lies inside one of today's windows (planAllows)
+ */
+void flowWindowTick(bit inWindow)
+{
+    bit open = inWindow && !flowInWindow;
+    bit close = !inWindow && flowInWindow;
+    flowInWindow = inWindow;
+    if (open)                                   // A window opens: new volume budget
+    {
+        flowWindow = 0;
+        flowDone = 0;
+    }
+    if (open || close)
+        flowSave();                             // Window state (and the day total) in NVRAM
+}
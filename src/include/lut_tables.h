@@ -0,0 +1,163 @@
+// ================== lut_tables.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// GENERATED by tools/gen_tables.py - do not edit. Lookup tables in CODE space for
+// pure conversion functions, from the scales and calibration below.
+// ----------------------------------------------------------
+// Inputs:
+//     -> ADC_PCT_NUM / ADC_PCT_DEN = 10 / 102 (my_private_header.h)
+//     -> SERVO_US_0 / SERVO_US_180 = 600 / 2400 us (site_config.h), SERVO_DEG_MAX = 180
+// Trade-off (CODE bytes; CIP-51 cycles per call, table vs arithmetic, estimates):
+//     Switch       Table            Bytes  Cycles     Used by
+//     LUT_ADC_PCT  adcPctTable       1024   12 vs 260  ADC_PCT(): count -> %, per sample
+//     LUT_BCD      bcdDecTable        256    6 vs 12   bcdToDec(), per RTC field
+//     LUT_BCD      decBcdTable        256    6 vs 20   decToBcd(), per RTC field
+//     LUT_SERVO    servoLutDefault    362   15 vs 35   servoLutBuild(), default cal., x181, boot only
+// Switches in my_private_header.h (1 = table, 0 = arithmetic); a table is only
+// linked in when its switch is on.
+
+// ---------- Generation Inputs (checked against the headers) ----------
+#define LUT_GEN_ADC_NUM     10
+#define LUT_GEN_ADC_DEN     102
+#define LUT_GEN_SERVO_US_0  600
+#define LUT_GEN_SERVO_US_180 2400
+#if LUT_GEN_ADC_NUM != ADC_PCT_NUM || LUT_GEN_ADC_DEN != ADC_PCT_DEN
+#error "lut_tables.h is out of date: run tools/gen_tables.py"
+#endif
+
+#if LUT_ADC_PCT
+// ADC count (0..1023) -> % = count * 10 / 102
+U8 code adcPctTable[1024] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   3,
+      3,   3,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   4,   4,
+      4,   4,   4,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   6,   6,
+      6,   6,   6,   6,   6,   6,   6,   6,   7,   7,   7,   7,   7,   7,   7,   7,
+      7,   7,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   9,   9,   9,   9,
+      9,   9,   9,   9,   9,   9,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+     10,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  12,  12,  12,  12,  12,
+     12,  12,  12,  12,  12,  13,  13,  13,  13,  13,  13,  13,  13,  13,  13,  14,
+     14,  14,  14,  14,  14,  14,  14,  14,  14,  15,  15,  15,  15,  15,  15,  15,
+     15,  15,  15,  15,  16,  16,  16,  16,  16,  16,  16,  16,  16,  16,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  18,  18,  18,  18,  18,  18,  18,  18,
+     18,  18,  19,  19,  19,  19,  19,  19,  19,  19,  19,  19,  20,  20,  20,  20,
+     20,  20,  20,  20,  20,  20,  20,  21,  21,  21,  21,  21,  21,  21,  21,  21,
+     21,  22,  22,  22,  22,  22,  22,  22,  22,  22,  22,  23,  23,  23,  23,  23,
+     23,  23,  23,  23,  23,  24,  24,  24,  24,  24,  24,  24,  24,  24,  24,  25,
+     25,  25,  25,  25,  25,  25,  25,  25,  25,  25,  26,  26,  26,  26,  26,  26,
+     26,  26,  26,  26,  27,  27,  27,  27,  27,  27,  27,  27,  27,  27,  28,  28,
+     28,  28,  28,  28,  28,  28,  28,  28,  29,  29,  29,  29,  29,  29,  29,  29,
+     29,  29,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  31,  31,  31,
+     31,  31,  31,  31,  31,  31,  31,  32,  32,  32,  32,  32,  32,  32,  32,  32,
+     32,  33,  33,  33,  33,  33,  33,  33,  33,  33,  33,  34,  34,  34,  34,  34,
+     34,  34,  34,  34,  34,  35,  35,  35,  35,  35,  35,  35,  35,  35,  35,  35,
+     36,  36,  36,  36,  36,  36,  36,  36,  36,  36,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  38,  38,  38,  38,  38,  38,  38,  38,  38,  38,  39,  39,
+     39,  39,  39,  39,  39,  39,  39,  39,  40,  40,  40,  40,  40,  40,  40,  40,
+     40,  40,  40,  41,  41,  41,  41,  41,  41,  41,  41,  41,  41,  42,  42,  42,
+     42,  42,  42,  42,  42,  42,  42,  43,  43,  43,  43,  43,  43,  43,  43,  43,
+     43,  44,  44,  44,  44,  44,  44,  44,  44,  44,  44,  45,  45,  45,  45,  45,
+     45,  45,  45,  45,  45,  45,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,
+     47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  48,  48,  48,  48,  48,  48,
+     48,  48,  48,  48,  49,  49,  49,  49,  49,  49,  49,  49,  49,  49,  50,  50,
+     50,  50,  50,  50,  50,  50,  50,  50,  50,  51,  51,  51,  51,  51,  51,  51,
+     51,  51,  51,  52,  52,  52,  52,  52,  52,  52,  52,  52,  52,  53,  53,  53,
+     53,  53,  53,  53,  53,  53,  53,  54,  54,  54,  54,  54,  54,  54,  54,  54,
+     54,  55,  55,  55,  55,  55,  55,  55,  55,  55,  55,  55,  56,  56,  56,  56,
+     56,  56,  56,  56,  56,  56,  57,  57,  57,  57,  57,  57,  57,  57,  57,  57,
+     58,  58,  58,  58,  58,  58,  58,  58,  58,  58,  59,  59,  59,  59,  59,  59,
+     59,  59,  59,  59,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  60,  61,
+     61,  61,  61,  61,  61,  61,  61,  61,  61,  62,  62,  62,  62,  62,  62,  62,
+     62,  62,  62,  63,  63,  63,  63,  63,  63,  63,  63,  63,  63,  64,  64,  64,
+     64,  64,  64,  64,  64,  64,  64,  65,  65,  65,  65,  65,  65,  65,  65,  65,
+     65,  65,  66,  66,  66,  66,  66,  66,  66,  66,  66,  66,  67,  67,  67,  67,
+     67,  67,  67,  67,  67,  67,  68,  68,  68,  68,  68,  68,  68,  68,  68,  68,
+     69,  69,  69,  69,  69,  69,  69,  69,  69,  69,  70,  70,  70,  70,  70,  70,
+     70,  70,  70,  70,  70,  71,  71,  71,  71,  71,  71,  71,  71,  71,  71,  72,
+     72,  72,  72,  72,  72,  72,  72,  72,  72,  73,  73,  73,  73,  73,  73,  73,
+     73,  73,  73,  74,  74,  74,  74,  74,  74,  74,  74,  74,  74,  75,  75,  75,
+     75,  75,  75,  75,  75,  75,  75,  75,  76,  76,  76,  76,  76,  76,  76,  76,
+     76,  76,  77,  77,  77,  77,  77,  77,  77,  77,  77,  77,  78,  78,  78,  78,
+     78,  78,  78,  78,  78,  78,  79,  79,  79,  79,  79,  79,  79,  79,  79,  79,
+     80,  80,  80,  80,  80,  80,  80,  80,  80,  80,  80,  81,  81,  81,  81,  81,
+     81,  81,  81,  81,  81,  82,  82,  82,  82,  82,  82,  82,  82,  82,  82,  83,
+     83,  83,  83,  83,  83,  83,  83,  83,  83,  84,  84,  84,  84,  84,  84,  84,
+     84,  84,  84,  85,  85,  85,  85,  85,  85,  85,  85,  85,  85,  85,  86,  86,
+     86,  86,  86,  86,  86,  86,  86,  86,  87,  87,  87,  87,  87,  87,  87,  87,
+     87,  87,  88,  88,  88,  88,  88,  88,  88,  88,  88,  88,  89,  89,  89,  89,
+     89,  89,  89,  89,  89,  89,  90,  90,  90,  90,  90,  90,  90,  90,  90,  90,
+     90,  91,  91,  91,  91,  91,  91,  91,  91,  91,  91,  92,  92,  92,  92,  92,
+     92,  92,  92,  92,  92,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  94,
+     94,  94,  94,  94,  94,  94,  94,  94,  94,  95,  95,  95,  95,  95,  95,  95,
+     95,  95,  95,  95,  96,  96,  96,  96,  96,  96,  96,  96,  96,  96,  97,  97,
+     97,  97,  97,  97,  97,  97,  97,  97,  98,  98,  98,  98,  98,  98,  98,  98,
+     98,  98,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99, 100, 100, 100, 100
+};
+#endif
+
+#if LUT_BCD
+// BCD byte -> decimal (every byte, same result as the arithmetic for invalid BCD)
+U8 code bcdDecTable[256] = {
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,
+     10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,
+     20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,
+     30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,
+     40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,
+     50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,
+     60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,
+     70,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,  84,  85,
+     80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,
+     90,  91,  92,  93,  94,  95,  96,  97,  98,  99, 100, 101, 102, 103, 104, 105,
+    100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115,
+    110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125,
+    120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135,
+    130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145,
+    140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155,
+    150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165
+};
+// Decimal -> BCD byte (every byte, same result as the arithmetic above 99)
+U8 code decBcdTable[256] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+    0x16, 0x17, 0x18, 0x19, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x30, 0x31,
+    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x60, 0x61, 0x62, 0x63,
+    0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95,
+    0x96, 0x97, 0x98, 0x99, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xB0, 0xB1,
+    0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7,
+    0xC8, 0xC9, 0xD0, 0xD1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xE0, 0xE1, 0xE2, 0xE3,
+    0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+    0x16, 0x17, 0x18, 0x19, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x30, 0x31,
+    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x60, 0x61, 0x62, 0x63,
+    0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95
+};
+#endif
+
+#if LUT_SERVO
+// PCA compare value per degree for the default calibration (600..2400 us)
+U16 code servoLutDefault[181] = {
+    0xF6A0, 0xF678, 0xF650, 0xF628, 0xF600, 0xF5D8, 0xF5B0, 0xF588, 0xF560, 0xF538,
+    0xF510, 0xF4E8, 0xF4C0, 0xF498, 0xF470, 0xF448, 0xF420, 0xF3F8, 0xF3D0, 0xF3A8,
+    0xF380, 0xF358, 0xF330, 0xF308, 0xF2E0, 0xF2B8, 0xF290, 0xF268, 0xF240, 0xF218,
+    0xF1F0, 0xF1C8, 0xF1A0, 0xF178, 0xF150, 0xF128, 0xF100, 0xF0D8, 0xF0B0, 0xF088,
+    0xF060, 0xF038, 0xF010, 0xEFE8, 0xEFC0, 0xEF98, 0xEF70, 0xEF48, 0xEF20, 0xEEF8,
+    0xEED0, 0xEEA8, 0xEE80, 0xEE58, 0xEE30, 0xEE08, 0xEDE0, 0xEDB8, 0xED90, 0xED68,
+    0xED40, 0xED18, 0xECF0, 0xECC8, 0xECA0, 0xEC78, 0xEC50, 0xEC28, 0xEC00, 0xEBD8,
+    0xEBB0, 0xEB88, 0xEB60, 0xEB38, 0xEB10, 0xEAE8, 0xEAC0, 0xEA98, 0xEA70, 0xEA48,
+    0xEA20, 0xE9F8, 0xE9D0, 0xE9A8, 0xE980, 0xE958, 0xE930, 0xE908, 0xE8E0, 0xE8B8,
+    0xE890, 0xE868, 0xE840, 0xE818, 0xE7F0, 0xE7C8, 0xE7A0, 0xE778, 0xE750, 0xE728,
+    0xE700, 0xE6D8, 0xE6B0, 0xE688, 0xE660, 0xE638, 0xE610, 0xE5E8, 0xE5C0, 0xE598,
+    0xE570, 0xE548, 0xE520, 0xE4F8, 0xE4D0, 0xE4A8, 0xE480, 0xE458, 0xE430, 0xE408,
+    0xE3E0, 0xE3B8, 0xE390, 0xE368, 0xE340, 0xE318, 0xE2F0, 0xE2C8, 0xE2A0, 0xE278,
+    0xE250, 0xE228, 0xE200, 0xE1D8, 0xE1B0, 0xE188, 0xE160, 0xE138, 0xE110, 0xE0E8,
+    0xE0C0, 0xE098, 0xE070, 0xE048, 0xE020, 0xDFF8, 0xDFD0, 0xDFA8, 0xDF80, 0xDF58,
+    0xDF30, 0xDF08, 0xDEE0, 0xDEB8, 0xDE90, 0xDE68, 0xDE40, 0xDE18, 0xDDF0, 0xDDC8,
+    0xDDA0, 0xDD78, 0xDD50, 0xDD28, 0xDD00, 0xDCD8, 0xDCB0, 0xDC88, 0xDC60, 0xDC38,
+    0xDC10, 0xDBE8, 0xDBC0, 0xDB98, 0xDB70, 0xDB48, 0xDB20, 0xDAF8, 0xDAD0, 0xDAA8,
+    0xDA80
+};
+#endif
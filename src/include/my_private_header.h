@@ -6,8 +6,10 @@
 // ----------------------------------------------------------
 // [1] Include Compiler and MCU Definitions:
 //     -> compiler_defs.h, C8051F380_defs.h
+//     -> timebase.h: hardware-timer timestamps and delays (waitUs() for the
+//        IC back-off and the ADC settling time)
 // [2] Constants and Timings:
-//     -> IC half-period timing definition (`usec`)
+//     -> IC timing profile (100 kHz / 400 kHz) derived from SYSCLK at compile time
 // [3] Pin Definitions:
 //     -> Assign symbolic names for MCU pins:
 //         IC communication pins (SDA, SCL)
@@ -16,30 +18,210 @@
 //     -> Low-level bit-banging implementation:
 //         START/STOP conditions
 //         Byte write/read functions
+//         Bounded waits, bus-clear recovery, status codes, retry + per-device counters
 // [5] LM75 Temperature Sensor Function:
 //     -> Temperature sensor reading function (`readTemp`)
+//     -> TOS/THYST programming for the O.S. comparator output (`setTempAlarm`)
+//     -> Sensor array: boot-time scan 0x48..0x4F, batched sampler with min/avg/max
 // [6] DS1307 RTC Control Functions:
-//     -> Read/Write RTC registers, time setup, printing
+//     -> Read/Write RTC registers (single and burst), time setup, printing
 //     -> BCD <-> Decimal conversion functions for RTC data formatting
 // [7] ADC Conversion Function:
 //     -> Read ADC channel values (soil, rain, light sensors)
-// [8] Servo PWM Control Function:
-//     -> PWM signal generation via PCA module
+//     -> Hardware window compare on the soil channel (`setSoilWindow`, ADC0 window ISR)
+// [8] Servo PWM Control:
+//     -> servo.h: PCA servo channels in degrees, loaded by the PCA frame interrupt
 // [9] Relay Control Functions:
 //     -> Relay activation/deactivation (pump control)
+// [10] Interrupt Map:
+//     -> Priority level and register bank of every ISR, ISR_PROFILE timing
+//     -> ISR_IN(id)/ISR_OUT(id) also drive the trace port (trace.h, TRACE_MODE)
 #include "compiler_defs.h"       // Include compiler definitions (macros, typedefs, etc.)  
 #include "C8051F380_defs.h"      // Include SFR definitions for the C8051F380  
-#define usec 3   // Half-period delay in microseconds for manual IC bit-banging
-                 // - Controls the HIGH/LOW time for SCL when toggling via GPIO
-                 // - Total clock period = 2  usec -> 6 s here  166 kHz IC speed
-                 // - Timing set manually (software-driven), not using built-in SMBus/IC hardware
+#ifdef SIM_HOST
+#include "sim_bus.h"             // Host build: virtual IC bus + LM75/DS1307 models (sim/)
+#endif
+#include "timebase.h"            // Timer2/PCA timestamps, elapsed(), waitUs()
+#include "trace.h"               // Logic-analyzer trace port (TRACE_MODE), VCD events in the simulation
+// ---------- [10] Interrupt Map ----------
+// Two priority levels, one register bank per level. An ISR can only be interrupted
+// by one of the other level, so all ISRs of a level share a bank and `using n`
+// replaces the R0..R7 pushes with one PSW write (entry + exit ~ 16 cycles less).
+//   Level  Bank  ISR (vector)              Rate              Priority reason
+//   high    2    Timer2_ISR (5)            1 kHz             timebase, shadow clock, watchdog feed
+//   low     1    PCA_ISR (11)              61 Hz             servo frame: ~14 ms before the next match
+//   low     1    Timer3_ISR (14)           100 Hz + samples  soil pipeline (settle window in hardware)
+//   low     1    ADC0_EOC_ISR (10)         per soil sample   reverse-polarity phase starts here
+//   low     1    ADC0_Window_ISR (9)       per crossing      soilDry flag only
+//   low     1    LM75_OS_ISR (0)           per O.S. edge     flags only
+//   -       0    main loop and everything it calls
+// Levels are set in Init_Device (step 14, IP / EIP1); a new source (UART, another
+// timer) gets its level first and then that level's bank.
+// ISR bodies:
+//   -> Call no C function compiled for bank 0 (it addresses R0..R7 absolutely and
+//      would overwrite the main loop's registers): shared helpers are macros
+//      (SOIL_PROBE_*, T3_RESTART, SOIL_WINDOW_ARM, SERVO_FRAME); servoStep() is
+//      compiled NOAREGS (servo.h), so it runs in the caller's bank
+//   -> No library calls (printf, delays, IC); the 32-bit adds and compares of
+//      Timer2_ISR are C51 runtime arithmetic, which works in the selected bank
+//   -> Data shared with the main loop is protected in the main loop (ETn / EIE1
+//      bit masked around the access), never by masking inside an ISR
+#define ISR_BANK_HI     2       // Register bank of the high-priority ISRs
+#define ISR_BANK_LO     1       // Register bank of the low-priority ISRs
+
+// ISR_PROFILE = 1: every ISR stamps Timer1 at the start and end of its body and keeps
+// its longest run in SYSCLK cycles (shown by the Check screen "Rate" button). Timer1
+// is otherwise unused and runs free at SYSCLK for the profiler only; unlike PCA0L,
+// reading TL1/TH1 latches nothing, so pcaNow()/waitUs() in the main loop are not
+// disturbed. A stamp reads TH1, TL1, TH1: a low byte >= 0x80 goes with the first
+// high byte, a smaller one with the second (TL1 wrapped between the reads).
+// Range 65535 cycles (1.37 ms). The prologue/epilogue and RETI (~20 cycles with a
+// bank switch) are outside the stamps; a low ISR interrupted by Timer2_ISR includes that run.
+#define ISR_PROFILE     0
+#define ISR_T2          0       // Profile slots
+#define ISR_PCA         1
+#define ISR_T3          2
+#define ISR_EOC         3
+#define ISR_WIN         4
+#define ISR_OS          5
+#define ISR_COUNT       6
+#if ISR_PROFILE && !defined(SIM_HOST)
+U16 xdata isrWorst[ISR_COUNT];  // Longest body per ISR (SYSCLK cycles)
+char code isrName[ISR_COUNT][4] = { "T2", "PCA", "T3", "EOC", "WIN", "OS" };
+#define ISR_T1(h, l, h2) ((((U16)((l) & 0x80 ? (h) : (h2))) << 8) | (l))  // Timer1 count from one stamp
+#define ISR_STAMP       U8 _isrH = TH1, _isrL = TL1, _isrH2 = TH1;   // Entry stamp (declarations)
+#define ISR_WORST(id)   { U8 _h = TH1, _l = TL1, _h2 = TH1; \
+                          U16 _t = ISR_T1(_h, _l, _h2) - ISR_T1(_isrH, _isrL, _isrH2); \
+                          if (_t > isrWorst[id]) isrWorst[id] = _t; }
+#define ISR_ROWS        ISR_COUNT   // Extra "Rate" button entries
+
+// isrProfileStart(): Timer1 free-running at SYSCLK, no interrupt (main(), after Init_Device).
+void isrProfileStart(void)
+{
+    TMOD = (TMOD & 0x0F) | 0x10;    // Timer1: mode 1 (16-bit), C/T1 = 0, GATE1 = 0
+    CKCON |= 0x08;                  // T1M = 1: Timer1 clocked by SYSCLK
+    ET1 = 0;
+    TR1 = 1;
+}
+
+// isrWorstCycles(): Longest body of an ISR in SYSCLK cycles (main loop only).
+U32 isrWorstCycles(U8 id)
+{
+    U16 t;
+    EA = 0;                     // 16-bit value written by the ISR
+    t = isrWorst[id];
+    EA = 1;
+    return t;
+}
+#else
+#define ISR_STAMP
+#define ISR_WORST(id)
+#define ISR_ROWS        0
+#define isrProfileStart()
+#endif
+// First and last line of every ISR body (ISR_IN is the last declaration). With
+// TRACE_MODE on, the trace writes are inside the profiled time.
+#define ISR_IN(id)      TRACE_SAVE ISR_STAMP TRACE(TR_ISR + (id))
+#define ISR_OUT(id)     { ISR_WORST(id) TRACE_RESTORE }
+// ---------- IC Timing Profile (compile time) ----------
+// SCL LOW/HIGH phase lengths are derived from SYSCLK and the selected bus mode.
+// Each phase is a DJNZ busy loop (I2C_LOW()/I2C_HIGH()) whose count is computed
+// by the preprocessor: loops = (phase cycles - edge overhead) / cycles per loop.
+// The edge overhead (sbit write, sclHigh() call and read-back) is an estimate;
+// build with I2C_BENCH = 1 to measure the real SCL frequency on the target.
+#define SYSCLK          48000000UL  // 24 MHz internal oscillator  2 (see Init_Device)
+#ifndef I2C_FAST_MODE               // (may be set on the command line, e.g. for the host simulation)
+#define I2C_FAST_MODE   0           // 0 = Standard mode 100 kHz, 1 = Fast mode 400 kHz
+#endif
+#define I2C_BENCH       0           // 1 = build the bus benchmark (Check screen "I2C" button)
+#define I2C_STD_LOW_NS  5000        // Standard mode: tLOW  >= 4.7 s (spec) -> 5 s
+#define I2C_STD_HIGH_NS 5000        // tHIGH >= 4.0 s (spec); LOW + HIGH = 10 s = 1 / 100 kHz
+#if I2C_FAST_MODE
+#define I2C_SCL_HZ      400000UL    // Fast mode
+#define I2C_LOW_NS      1400        // tLOW  >= 1.3 s (spec) -> 1.4 s
+#define I2C_HIGH_NS     1100        // tHIGH >= 0.6 s (spec); LOW + HIGH = 2.5 s = 1 / 400 kHz
+#else
+#define I2C_SCL_HZ      100000UL    // Standard mode
+#define I2C_LOW_NS      I2C_STD_LOW_NS
+#define I2C_HIGH_NS     I2C_STD_HIGH_NS
+#endif
+#define I2C_EDGE_CYCLES 24          // SYSCLK cycles spent per phase outside the delay loop (estimate)
+#define I2C_LOOP_CYCLES 4           // SYSCLK cycles per DJNZ iteration (CIP-51, flash prefetch)
+#define I2C_NS_CYCLES(ns) ((SYSCLK / 1000000UL) * (ns) / 1000UL)   // ns -> SYSCLK cycles
+#define I2C_LOOPS(ns)   ((I2C_NS_CYCLES(ns) > I2C_EDGE_CYCLES + I2C_LOOP_CYCLES) ? \
+                         (I2C_NS_CYCLES(ns) - I2C_EDGE_CYCLES) / I2C_LOOP_CYCLES : 1)
+#define I2C_LOW_LOOPS   I2C_LOOPS(I2C_LOW_NS)   // 54 (100 kHz) / 10 (400 kHz)
+#define I2C_HIGH_LOOPS  I2C_LOOPS(I2C_HIGH_NS)  // 54 (100 kHz) /  7 (400 kHz)
+#define I2C_STD_LOW_LOOPS  I2C_LOOPS(I2C_STD_LOW_NS)
+#define I2C_STD_HIGH_LOOPS I2C_LOOPS(I2C_STD_HIGH_NS)
+#if I2C_STD_LOW_LOOPS > 255 || I2C_STD_HIGH_LOOPS > 255
+#error "I2C phase does not fit the 8-bit delay loop - lower SYSCLK or raise I2C_SCL_HZ"
+#endif
+// The DS1307 is rated for Standard mode (100 kHz) only. With I2C_FAST_MODE its
+// transactions switch to the Standard-mode phase counts (I2C_SLOW() ... I2C_FAST()
+// in the DS1307 functions) and only the LM75s run at 400 kHz. The phase counts are
+// then variables: MOV Rn,direct costs the same 2 cycles as MOV Rn,#data.
+#if I2C_FAST_MODE
+U8 i2cLowLoops  = I2C_LOW_LOOPS;    // Phase counts of the running transaction
+U8 i2cHighLoops = I2C_HIGH_LOOPS;
+#define I2C_SLOW()  { i2cLowLoops = I2C_STD_LOW_LOOPS; i2cHighLoops = I2C_STD_HIGH_LOOPS; }
+#define I2C_FAST()  { i2cLowLoops = I2C_LOW_LOOPS; i2cHighLoops = I2C_HIGH_LOOPS; }
+#else
+#define i2cLowLoops     I2C_LOW_LOOPS
+#define i2cHighLoops    I2C_HIGH_LOOPS
+#define I2C_SLOW()
+#define I2C_FAST()
+#endif
+#ifndef SIM_HOST
+#define I2C_LOW()   { U8 _n = i2cLowLoops;  while (--_n); }     // SCL LOW phase / bus-free time
+#define I2C_HIGH()  { U8 _n = i2cHighLoops; while (--_n); }     // SCL HIGH phase / START-STOP setup & hold
+#else   // Host simulation: charge the same SYSCLK cycles to the simulated clock
+#define I2C_LOW()   simDelayCycles(I2C_EDGE_CYCLES + (U32)i2cLowLoops  * I2C_LOOP_CYCLES)
+#define I2C_HIGH()  simDelayCycles(I2C_EDGE_CYCLES + (U32)i2cHighLoops * I2C_LOOP_CYCLES)
+#endif
+#define ADC_SETTLE_US   3           // Multiplexer settling time before an ADC conversion (s)
+#define ADC_PCT_NUM     10          // ADC count -> %: count  10 / 102 (1023 -> 100 %)
+#define ADC_PCT_DEN     102
+// ---------- Lookup Tables (tools/gen_tables.py -> lut_tables.h) ----------
+// 1 = the function reads a generated CODE table, 0 = it computes; table sizes and
+// cycle estimates are in the lut_tables.h banner. Rerun the generator after a
+// change of ADC_PCT_NUM/DEN or SERVO_US_0/180 (a stale table stops the build).
+#define LUT_ADC_PCT     1           // ADC_PCT(): 1 KB, no 16-bit divide per sample
+#define LUT_BCD         0           // bcdToDec()/decToBcd(): 2  256 B for a few cycles per RTC field
+#define LUT_SERVO       0           // servoLutBuild() copies the default-calibration table (boot only)
+#include "lut_tables.h"
  
 // ---------- I2C Pin Definitions ----------  
+// The driver touches the lines only through SDA_OUT/SCL_OUT/SDA_IN/SCL_IN, so the
+// same code runs on the target (sbit access) and in the host simulation (SIM_HOST),
+// where the pins are wired-AND lines shared with virtual LM75/DS1307 models.
+#ifndef SIM_HOST
 sbit SDA = P1^1;                // I2C data line (SDA) connected to Port 1, Pin 1  
 sbit SCL = P1^0;                // I2C clock line (SCL) connected to Port 1, Pin 0  
+#define SDA_OUT(b)  (SDA = (b)) // Drive SDA (0 = pull low, non-zero = release to pull-up)
+#define SCL_OUT(b)  (SCL = (b)) // Drive SCL
+#define SDA_IN()    (SDA)       // Read back the SDA line level
+#define SCL_IN()    (SCL)       // Read back the SCL line level
+#else
+#define SDA_OUT(b)  simSdaOut(b)
+#define SCL_OUT(b)  simSclOut(b)
+#define SDA_IN()    simSdaIn()
+#define SCL_IN()    simSclIn()
+#endif
 
 // ---------- Relay Pin Definition ----------  
+#ifndef SIM_HOST
 sbit Relay = P0^2;              // Relay control pin (active-high) on Port 0, Pin 2  
+#else
+U8 Relay = 0;                   // Host simulation: pump state only
+#endif
+
+// ---------- LM75 O.S. Pin Definition ----------
+#ifndef SIM_HOST
+sbit LM75_OS = P0^7;            // LM75 O.S. output (open-drain, active-low) -> also routed to /INT0
+#else
+#define LM75_OS lm75OsLine()    // Host simulation: O.S. line of the virtual LM75(s)
+#endif
 
 // ======================= IC FUNCTIONS (Bit-Banged) ======================= Inter-Integrated Circuit
 // IC Protocol Sequence (master):
@@ -52,21 +234,146 @@ sbit Relay = P0^2;              // Relay control pin (active-high) on Port 0, Pi
 // Final:  STOP condition
 // Implementation notes (this module):
 // - Manual IC using bit-banging (software-driven timing), not the built-in SMBus/IC HW.
-// - Lines used in this project: SCL = P1.0 (Push-Pull), SDA = P1.1 (Open-Drain + Pull-Up).
-// - Bus speed is set by delays: SCL period  2 * usec (in microseconds).
-//   Example: usec = 3 -> T_SCL  6 s -> f_SCL  166.7 kHz.
+// - Lines used in this project: SCL = P1.0, SDA = P1.1 (both Open-Drain + Pull-Up).
+// - Bus speed is set by the timing profile: SCL period = LOW + HIGH phase
+//   (I2C_LOW_NS + I2C_HIGH_NS), e.g. 5 s + 5 s -> 100 kHz, 1.4 s + 1.1 s -> 400 kHz.
+//   DS1307 transactions always run at 100 kHz (I2C_SLOW()/I2C_FAST()).
 // - START = SDA falling while SCL is HIGH; STOP = SDA rising while SCL is HIGH.
-// - This implementation assumes master-driven SCL (no clock stretching by slaves).
+// - Slaves may stretch the clock: after releasing SCL the master waits for it to read
+//   HIGH, but at most I2C_STRETCH_MAX polls (SCL is open-drain so it can be read back).
+// - Every wait is bounded, so a transaction can never hang the main loop:
+//   worst case per attempt ~ (bytes  9 + 4)  (1 / I2C_SCL_HZ + I2C_STRETCH_MAX polls)
+//                            + one 9-clock bus clear,
+//   times (I2C_RETRIES + 1) attempts, plus back-off delays of I2C_BACKOFF_US << attempt.
+// - Errors are reported as status codes (I2C_OK .. I2C_BUS_STUCK) to the device functions,
+//   which retry, keep per-device counters (I2cDevice) and only overwrite the caller's
+//   value on success (last good value + age stamp).
 // ==========================================================================
+// ---------- Status Codes and Limits ----------
+#define I2C_OK          0       // Transaction complete, every byte ACKed
+#define I2C_NACK        1       // A byte was not acknowledged (device absent or busy)
+#define I2C_TIMEOUT     2       // A slave held SCL low longer than I2C_STRETCH_MAX polls
+#define I2C_BUS_STUCK   3       // SDA still held low after the 9-clock bus clear
+#define I2C_STRETCH_MAX 250     // Max SCL polls while a slave stretches the clock (~ 60 s at 48 MHz)
+#define I2C_RETRIES     2       // Extra attempts after a failed transaction
+#define I2C_BACKOFF_US  100     // Back-off before retry n = I2C_BACKOFF_US << n (100, 200 s)
+
+U8  i2cError = I2C_OK;          // Sticky bus error of the current transaction (cleared by START)
+U16 i2cBusClears = 0;           // Number of 9-clock bus-clear recoveries performed
+U16 loopTicks = 0;              // Age time base: advanced once per main-loop pass (~20 ms)
+#if I2C_BENCH
+U16 i2cClocks = 0;              // SCL rising edges generated (bench mode only)
+U16 i2cBytes  = 0;              // Bytes transferred incl. address bytes (bench mode only)
+#endif
+
+// Per-device bookkeeping (one record per IC slave)
+typedef struct
+{
+    U8  status;                 // Status of the last transaction (I2C_OK .. I2C_BUS_STUCK)
+    U16 errors;                 // Transactions that still failed after all retries
+    U16 retries;                // Extra attempts used (all transactions)
+    U16 stamp;                  // loopTicks of the last good transaction -> age = loopTicks - stamp
+} I2cDevice;
+
+I2cDevice lm75Dev = { I2C_OK, 0, 0, 0 };   // LM75 temperature sensor
+I2cDevice rtcDev  = { I2C_OK, 0, 0, 0 };   // DS1307 real-time clock
+
+/*
+ * sclHigh(): Releases SCL and waits (bounded) until it actually reads HIGH.
+ *   - A slave stretching the clock keeps SCL low; give up after I2C_STRETCH_MAX polls
+ *     and flag I2C_TIMEOUT so the rest of the transaction is skipped.
+ */
+void sclHigh(void)
+{
+    U8 n = I2C_STRETCH_MAX;
+#if I2C_BENCH
+    i2cClocks++;                    // One SCL clock per release
+#endif
+    SCL_OUT(1); // Release SCL (pull-up takes it HIGH)
+    while (!SCL_IN()) // Slave is stretching the clock
+    {
+        if (--n == 0)
+        {
+            i2cError = I2C_TIMEOUT; // Clock never came back -> abort transaction
+            return;
+        }
+    }
+}
+
+/*
+ * i2cBusClear(): Recovers a bus whose SDA is held LOW by a slave stuck mid-byte.
+ *   - Clocks SCL up to 9 times (one full byte + ACK slot) until the slave releases
+ *     SDA, then generates a STOP so every slave returns to idle.
+ * Returns:
+ *   1 = bus free (SDA HIGH), 0 = SDA still stuck LOW
+ */
+bit i2cBusClear(void)
+{
+    U8 i;
+    i2cBusClears++;
+    SDA_OUT(1); // Master releases SDA
+    for (i = 0; i < 9 && !SDA_IN(); i++) // At most 9 clocks, stop as soon as SDA is released
+    {
+        SCL_OUT(0);
+        I2C_LOW();
+        sclHigh();
+        I2C_HIGH();
+    }
+    SCL_OUT(0); // STOP: SDA low -> SCL high -> SDA high
+    SDA_OUT(0);
+    I2C_LOW();
+    sclHigh();
+    I2C_HIGH();
+    SDA_OUT(1);
+    I2C_LOW();
+    return SDA_IN();
+}
+
+// i2cResult(): Combines the sticky bus error with the ACK result of the transaction.
+U8 i2cResult(bit nack)
+{
+    if (i2cError != I2C_OK) return i2cError;
+    return nack ? I2C_NACK : I2C_OK;
+}
+
+/*
+ * i2cRetry(): Decides whether a device transaction is repeated, and books the outcome.
+ *   - Failed and attempts left -> count the retry, back off, return 1 (try again).
+ *   - Otherwise record the final status: errors++ on failure, age stamp on success.
+ * Usage:
+ *   attempt = 0; do { ...transaction -> st... } while (i2cRetry(&dev, st, attempt++));
+ */
+bit i2cRetry(I2cDevice *dev, U8 st, U8 attempt)
+{
+    if (st != I2C_OK && attempt < I2C_RETRIES)
+    {
+        dev->retries++;
+        waitUs(I2C_BACKOFF_US << attempt);    // Give a busy slave time before the next attempt
+        return 1;
+    }
+    dev->status = st;
+    if (st == I2C_OK)
+        dev->stamp = loopTicks;     // Fresh value -> age restarts at 0
+    else
+        dev->errors++;              // Caller keeps its last good value
+    return 0;
+}
+
 // Step 1: START condition
 void startI2c(void) // Step 1: START condition
 {
-    SDA = 1;               // Ensure SDA is released high (idle)
-    SCL = 1;               // Ensure SCL is released high (bus idle)
-    delay_us(usec);        // Stabilization delay (defines timing; see usec)
-    SDA = 0;               // SDA goes LOW while SCL is HIGH -> START condition
-    delay_us(usec);        // Allow slaves to detect START
-    SCL = 0;               // Pull SCL LOW to begin the data/clock phase
+    i2cError = I2C_OK;     // New transaction -> clear sticky error
+    SDA_OUT(1); // Ensure SDA is released high (idle)
+    sclHigh();             // Ensure SCL is released high (bus idle, bounded wait)
+    I2C_HIGH();            // Stabilization delay (START setup time, see timing profile)
+    if (!SDA_IN() && !i2cBusClear()) // SDA held low by a slave -> 9-clock recovery
+    {
+        i2cError = I2C_BUS_STUCK;  // Still stuck: no START, transaction is skipped
+        return;                    // (SCL stays released, so stopI2c() adds no clock pulse)
+    }
+    SDA_OUT(0); // SDA goes LOW while SCL is HIGH -> START condition
+    I2C_HIGH();        // Allow slaves to detect START
+    SCL_OUT(0); // Pull SCL LOW to begin the data/clock phase
 }
 /*
  * writeByteI2c(): Sends a single byte over IC, MSB first, and receives ACK/NACK.
@@ -77,33 +384,37 @@ void startI2c(void) // Step 1: START condition
  *   - Releases SDA for 9th bit to allow slave to respond with ACK or NACK.
  * Returns:
  *   - 0 = ACK received (slave pulled SDA low)
- *   - 1 = NACK (slave left SDA high)
+ *   - 1 = NACK (slave left SDA high), or the transaction already failed (i2cError)
  * Notes:
- *   - Timing is software-defined via delay_us(usec) on each edge (bit-banging).
+ *   - Timing is software-defined via I2C_LOW()/I2C_HIGH() on each edge (bit-banging).
  *   - Ensure 'startI2c()' was called before the first write, and 'stopI2c()' after the last byte.
  */
 bit writeByteI2c(U8 outchar) // Step 2 + Step 3: Send byte + receive ACK
 {
     bit ack;
     U8 i;
+    if (i2cError != I2C_OK) return 1; // Bus already failed in this transaction -> skip
+#if I2C_BENCH
+    i2cBytes++;
+#endif
     for(i = 0; i < 8; i++)
     {
-        outchar = outchar << 1;  // Shift MSB into CY (carry)
-        SDA = CY;                // Output current bit on SDA (MSB first)
-        delay_us(usec);          // Setup time before clock HIGH
-        SCL = 1;                 // Clock HIGH -> slave samples SDA
-        delay_us(usec);          
-        SCL = 0;                 // Clock LOW -> prepare next bit
+        SDA_OUT(outchar & 0x80); // Output current bit on SDA (MSB first)
+        outchar = outchar << 1;  // Next bit into the MSB position
+        I2C_LOW();           // Setup time before clock HIGH
+        sclHigh();               // Clock HIGH -> slave samples SDA (bounded stretch wait)
+        I2C_HIGH();
+        SCL_OUT(0); // Clock LOW -> prepare next bit
     }
 
-    delay_us(usec);              // Wait before ACK cycle
+    I2C_LOW();               // Wait before ACK cycle
 
-    SDA = 1;                     // Release SDA for slave to send ACK on 9th clock
-    SCL = 1;                     // Clock HIGH to sample ACK
-    delay_us(usec);              
-    ack = SDA;                   // Read SDA: 0 = ACK, 1 = NACK
-    SCL = 0;                     // Clock LOW to complete ACK cycle
-    delay_us(usec);              
+    SDA_OUT(1); // Release SDA for slave to send ACK on 9th clock
+    sclHigh();                   // Clock HIGH to sample ACK
+    I2C_HIGH();
+    ack = SDA_IN() | (i2cError != I2C_OK); // Read SDA: 0 = ACK, 1 = NACK (or clock timeout)
+    SCL_OUT(0); // Clock LOW to complete ACK cycle
+    I2C_LOW();
     return ack;                  // Return ACK/NACK status
 }
 /*
@@ -119,29 +430,33 @@ bit writeByteI2c(U8 outchar) // Step 2 + Step 3: Send byte + receive ACK
  *   Byte received from slave.
  * Notes:
  *   - Use ACK (0) for all bytes except the last; send NACK (1) on the final byte before STOP.
- *   - Timing is software-defined via delay_us(usec) on each edge (bit-banging).
+ *   - Timing is software-defined via I2C_LOW()/I2C_HIGH() on each edge (bit-banging).
  */
 U8 readByteI2c(bit ask_master) // Step 4 + Step 5: Read byte and send ACK/NACK
 {
     U8 i2cData = 0;
     U8 i;
-    SDA = 1;                    // Release SDA -> input mode (slave drives SDA)
+    if (i2cError != I2C_OK) return 0xFF; // Bus already failed in this transaction -> skip
+#if I2C_BENCH
+    i2cBytes++;
+#endif
+    SDA_OUT(1); // Release SDA -> input mode (slave drives SDA)
     for(i = 7; ; i--)
     {
-        SCL = 1;                // Clock HIGH -> slave outputs current bit on SDA
-        delay_us(usec);         
-        if(SDA)                 // If SDA is HIGH, set corresponding bit
+        sclHigh();              // Clock HIGH -> slave outputs current bit on SDA (bounded stretch wait)
+        I2C_HIGH();
+        if(SDA_IN()) // If SDA is HIGH, set corresponding bit
             i2cData |= (1 << i);
-        SCL = 0;                // Clock LOW -> prepare for next bit
-        delay_us(usec);         
+        SCL_OUT(0); // Clock LOW -> prepare for next bit
+        I2C_LOW();
         if(i == 0) break;       // Exit after 8 bits
     }
-    SDA = ask_master;          // Master drives ACK (0) to continue, or NACK (1) to stop
-    delay_us(usec);            
-    SCL = 1;                    // Clock HIGH to send ACK/NACK on the 9th clock
-    delay_us(usec);            
-    SCL = 0;                    // Clock LOW to complete ACK/NACK cycle
-    delay_us(usec);            
+    SDA_OUT(ask_master); // Master drives ACK (0) to continue, or NACK (1) to stop
+    I2C_LOW();
+    sclHigh();                  // Clock HIGH to send ACK/NACK on the 9th clock
+    I2C_HIGH();
+    SCL_OUT(0); // Clock LOW to complete ACK/NACK cycle
+    I2C_LOW();
     return i2cData;             // Return received byte
 }
 /*
@@ -155,15 +470,15 @@ U8 readByteI2c(bit ask_master) // Step 4 + Step 5: Read byte and send ACK/NACK
  */
 void stopI2c(void) // Step 5: STOP condition
 {
-    SDA = 0;               // Hold SDA low before STOP
-    SCL = 1;               // Raise SCL to prepare for STOP condition
-    delay_us(usec);        // Setup delay (defines timing; see usec)
-    SDA = 1;               // SDA goes HIGH while SCL is HIGH -> STOP condition
-    delay_us(usec);        // Ensure STOP is registered by all slaves
+    SDA_OUT(0); // Hold SDA low before STOP
+    sclHigh();             // Raise SCL to prepare for STOP condition (bounded stretch wait)
+    I2C_HIGH();            // STOP setup time (see timing profile)
+    SDA_OUT(1); // SDA goes HIGH while SCL is HIGH -> STOP condition
+    I2C_LOW();         // Ensure STOP is registered by all slaves
 }
 // ---------- LM75 TEMPERATURE SENSOR Function ----------
 /*
- * readTemp(): Reads and decodes the temperature value from the LM75 sensor over IC.
+ * lm75ReadRaw() / readTemp(): Read and decode the temperature value from an LM75 over IC.
  * Description:
  *   - LM75 outputs temperature as a 9-bit value spread across 2 bytes: MSB and LSB.
  *   - MSB (Byte 1): Bits [7:0] contain the upper 8 bits of temperature data.
@@ -188,21 +503,278 @@ void stopI2c(void) // Step 5: STOP condition
  *   7) Read LSB (NACK)
  *   8) STOP
  *
+ * lm75ReadRaw() does the transaction for any LM75 (own retry record `dev`) and
+ * returns the raw 16-bit word; readTemp() is the single-sensor wrapper in C.
  * Parameters:
+ *   dev  per-device retry/error record (lm75Dev, or one entry of the sensor array)
  *   add  LM75 IC address with R/W bit = 1 (read mode).
+ *   raw  receives (MSB << 8) | LSB; left untouched on failure
+ * Returns:
+ *   I2C_OK or the IC status of the last failed attempt (retried I2C_RETRIES times)
+ */
+U8 lm75ReadRaw(I2cDevice *dev, U8 add, U16 *raw)
+{
+    U8 st, attempt = 0;
+    U8 msb = 0, lsb = 0;
+    do {
+        startI2c();                         // Send I2C START condition
+        if(!writeByteI2c(add))              // Send LM75 IC address (read mode), wait for ACK
+        {
+            msb = readByteI2c(0);           // Read MSB (first byte) Most Significant Bit/Byte, send ACK
+            lsb = readByteI2c(1);           // Read LSB (second byte, only bit 7 is relevant), send NACK
+            stopI2c();                      // Send I2C STOP condition
+            st = i2cResult(0);              // Bytes received -> OK unless the clock timed out
+        }
+        else
+        {
+            stopI2c();                      // Address NACKed (or bus error): release the bus
+            st = i2cResult(1);
+        }
+    } while (i2cRetry(dev, st, attempt++));
+    if (st == I2C_OK)
+        *raw = ((U16)msb << 8)              // MSB shifted to upper bits
+             + lsb;                         // + LSB
+    return st;                              // Status for the caller (raw only valid on I2C_OK)
+}
+
+/*
+ * readTemp(): Single-sensor read in C (bookkeeping in lm75Dev).
+ *   temp receives the temperature in degrees Celsius (C); left untouched on failure,
+ *   so the caller keeps its last good value (age: loopTicks - lm75Dev.stamp).
+ */
+U8 readTemp(U8 add, float *temp)
+{
+    U16 raw;
+    U8 st = lm75ReadRaw(&lm75Dev, add, &raw);
+    if (st == I2C_OK)
+        *temp = ((S16)raw >> 5) * 0.125;    // Signed 11-bit value (arithmetic right-shift by 5), then multiply by resolution (0.125C/LSB)
+    return st;
+}
+
+// ---------- LM75 O.S. COMPARATOR (hardware temperature threshold) ----------
+// The LM75 compares every conversion against TOS/THYST on its own and drives O.S.:
+//   - Comparator mode: O.S. goes active when T >= TOS, released when T < THYST.
+//   - O.S. is open-drain, active-low -> LM75_OS == 0 means "too hot".
+// TOS/THYST format: 9-bit two's complement, MSB = whole C, LSB bit 7 = 0.5C.
+// Once programmed, the irrigation logic only reads the LM75_OS bit; the full
+// temperature read is needed only for the display.
+#define LM75_ADDR       0x48    // 7-bit LM75 address (A2..A0 = 000)
+#define LM75_REG_TEMP   0x00    // Temperature register (read-only)
+#define LM75_REG_CONF   0x01    // Configuration register
+#define LM75_REG_THYST  0x02    // Hysteresis register (O.S. release point)
+#define LM75_REG_TOS    0x03    // Over-temperature register (O.S. trip point)
+#define LM75_CONF_COMP  0x10    // Comparator mode, O.S. active-low, fault queue = 4 (ignores single noisy samples)
+#define LM75_HYST       1       // THYST = TOS - 1C -> O.S. does not chatter around the threshold
+
+/*
+ * writeLM75(): Writes the register pointer and 0, 1 or 2 data bytes to the LM75.
+ * IC: START -> [add W] -> [reg] -> ([msb]) -> ([lsb]) -> STOP
+ * Parameters:
+ *   dev   - per-device retry/error record (lm75Dev, or one entry of the sensor array)
+ *   add   - LM75 IC address with R/W bit = 0 (write mode), e.g. (LM75_ADDR << 1)
+ *   reg   - register pointer (LM75_REG_xxx)
+ *   count - number of data bytes to send after the pointer (0 = pointer only)
+ * Returns:
+ *   I2C_OK, or the status of the last failed attempt
+ */
+U8 writeLM75(I2cDevice *dev, U8 add, U8 reg, U8 msb, U8 lsb, U8 count)
+{
+    bit ack;
+    U8 st, attempt = 0;
+    do {
+        ack = 1;                                // Assume NACK until the address is ACKed
+        startI2c();                             // START condition
+        if (!writeByteI2c(add))                 // Address+W, ACK expected
+        {
+            ack = writeByteI2c(reg);            // Register pointer
+            if (count > 0 && !ack)
+                ack = writeByteI2c(msb);        // First data byte (config or MSB)
+            if (count > 1 && !ack)
+                ack = writeByteI2c(lsb);        // Second data byte (LSB of TOS/THYST)
+        }
+        stopI2c();                              // STOP condition
+        st = i2cResult(ack);
+    } while (i2cRetry(dev, st, attempt++));
+    return st;
+}
+
+/*
+ * setTempAlarm(): Programs TOS/THYST from the runtime temperature threshold.
+ *   - Call on boot and whenever TEMP_THRESHOLD changes.
+ *   - Leaves the LM75 pointer on the temperature register, because readTemp()
+ *     reads from the current pointer without setting it.
+ * Parameters:
+ *   dev       - retry/error record of this sensor (see writeLM75())
+ *   add       - LM75 IC address with R/W bit = 0 (write mode)
+ *   threshold - trip point in whole C (O.S. active when T >= threshold)
+ * Returns:
+ *   I2C_OK, or the status of the first write that failed (later writes are skipped)
+ */
+U8 setTempAlarm(I2cDevice *dev, U8 add, S8 threshold)
+{
+    U8 st;
+    st = writeLM75(dev, add, LM75_REG_CONF,  LM75_CONF_COMP,         0x00, 1);                  // Comparator mode
+    if (st == I2C_OK) st = writeLM75(dev, add, LM75_REG_THYST, threshold - LM75_HYST, 0x00, 2); // Release point
+    if (st == I2C_OK) st = writeLM75(dev, add, LM75_REG_TOS,   threshold,             0x00, 2); // Trip point
+    if (st == I2C_OK) st = writeLM75(dev, add, LM75_REG_TEMP,  0x00,                  0x00, 0); // Park pointer on temperature
+    return st;
+}
+
+// O.S. edge interrupt (/INT0 on P0.7, falling edge = threshold crossed upwards).
+// The irrigation decision reads LM75_OS directly; the ISR only asks the main
+// loop for an early display refresh of the temperature value.
+bit tempRefresh = 0;                // Set by ISR -> main loop reads the LM75 on the next pass
+U8  tempAlarmEdges = 0;             // Number of O.S. assertions since reset (diagnostics)
+
+#ifndef SIM_HOST
+void LM75_OS_ISR(void) interrupt 0 using ISR_BANK_LO
+{
+    ISR_IN(ISR_OS)
+    tempAlarmEdges++;               // Count threshold crossings
+    tempRefresh = 1;                // Request a full temperature read for the display
+    ISR_OUT(ISR_OS);
+}
+#endif
+
+// ---------- LM75 SENSOR ARRAY (boot-time scan + batched sampler) ----------
+// Up to 8 LM75s share the bus (A2..A0 -> 0x48..0x4F) and their open-drain O.S.
+// outputs share P0.7 (wired-OR, active-low):
+//   - lm75Scan() runs once at boot and keeps every address that ACKs *and* looks
+//     like an LM75 (reserved CONF bits 7:5 = 0, unused TOS/THYST LSB bits = 0),
+//     so other parts in the same address range (ADCs, expanders) are skipped.
+//   - lm75SampleAll() reads every found sensor in one pass from the parked
+//     temperature pointer (3 bytes, 28 SCL clocks each -> bus time grows linearly
+//     with the number of sensors) and aggregates min/avg/max in 1/8 C.
+//   - lm75AlarmAll() programs the same TOS/THYST into every sensor, so the shared
+//     O.S. line is active as soon as the hottest point reaches the threshold.
+// Each pass is timed with the PCA0 counter (0.25 s ticks). 8 sensors take
+// ~2.5 ms at 100 kHz, well inside one 16.384 ms PCA period, so a 16-bit
+// difference is exact.
+#define LM75_MAX        8       // LM75 address range 0x48..0x4F
+
+typedef struct
+{
+    U8  addr;                   // 7-bit IC address
+    S16 t8;                     // Last good temperature in 1/8 C (two's complement)
+    I2cDevice dev;              // Retry / error / age bookkeeping of this sensor
+} Lm75Sensor;
+
+Lm75Sensor xdata lm75s[LM75_MAX];   // Sensors found by lm75Scan(), in address order
+U8  lm75Count = 0;                  // Number of valid entries in lm75s[]
+U8  lm75Valid = 0;                  // Sensors that answered in the last pass
+S16 lm75Min8 = 0, lm75Avg8 = 0, lm75Max8 = 0;   // Aggregate of the last pass (1/8 C)
+U16 lm75PassTicks = 0;              // Bus time of the last pass in PCA ticks (0.25 s)
+
+/*
+ * lm75ReadReg(): Sets the LM75 pointer and reads `n` bytes (1 or 2) from it.
+ * IC: START -> [add W] -> [reg] -> STOP -> START -> [add R] -> data (NACK last) -> STOP
+ * The pointer stays on `reg` afterwards; retries of the pointer write are booked on `dev`.
+ */
+U8 lm75ReadReg(I2cDevice *dev, U8 addr7, U8 reg, U8 *buf, U8 n)
+{
+    U8 i, st = writeLM75(dev, addr7 << 1, reg, 0x00, 0x00, 0); // Pointer only
+    if (st != I2C_OK) return st;
+    startI2c();
+    if (writeByteI2c((addr7 << 1) | 1))                     // Address+R
+    {
+        stopI2c();
+        return i2cResult(1);
+    }
+    for (i = 0; i < n; i++)
+        buf[i] = readByteI2c(i == n - 1);                   // NACK the last byte
+    stopI2c();
+    return i2cResult(0);
+}
+
+/*
+ * lm75Scan(): Discovers the LM75-class sensors on the bus (call once at boot).
+ *   - An address probe (START, address+W, STOP) finds who ACKs, without retries.
+ *   - Devices that ACK are checked through their registers, then the pointer is
+ *     parked on the temperature register for lm75SampleAll().
+ * Returns:
+ *   Number of sensors found (also in lm75Count)
+ */
+U8 lm75Scan(void)
+{
+    U8 a, nack, conf, hyst[2], tos[2];
+    Lm75Sensor xdata *s;
+    lm75Count = 0;
+    for (a = LM75_ADDR; a < LM75_ADDR + LM75_MAX; a++)
+    {
+        startI2c();
+        nack = writeByteI2c(a << 1);                        // Probe: does anything ACK here?
+        stopI2c();
+        if (nack) continue;
+        s = &lm75s[lm75Count];                              // Candidate entry, kept if it is an LM75
+        s->addr = a;
+        s->t8 = 0;
+        s->dev.status = I2C_OK;
+        s->dev.errors = 0;
+        s->dev.retries = 0;
+        s->dev.stamp = loopTicks;
+        if (lm75ReadReg(&s->dev, a, LM75_REG_CONF,  &conf, 1) != I2C_OK ||
+            lm75ReadReg(&s->dev, a, LM75_REG_THYST, hyst, 2)  != I2C_OK ||
+            lm75ReadReg(&s->dev, a, LM75_REG_TOS,   tos, 2)   != I2C_OK)
+            continue;
+        if ((conf & 0xE0) || (hyst[1] & 0x7F) || (tos[1] & 0x7F))
+            continue;                                       // ACKs, but not an LM75
+        writeLM75(&s->dev, a << 1, LM75_REG_TEMP, 0x00, 0x00, 0);  // Park pointer on temperature
+        lm75Count++;
+    }
+    return lm75Count;
+}
+
+/*
+ * lm75SampleAll(): Reads every sensor found by lm75Scan() in one pass.
+ *   - A sensor that fails (after retries) keeps its last good value and is left
+ *     out of the aggregate; lm75Valid counts the sensors that answered.
+ *   - The aggregate keeps its previous value when no sensor answered.
+ * Returns:
+ *   lm75Valid
+ */
+U8 lm75SampleAll(void)
+{
+    U8 i;
+    U16 raw, t0;
+    S16 t8, lo = 0x7FFF, hi = -0x7FFF;
+    S32 sum = 0;
+    lm75Valid = 0;
+    t0 = pcaNow();                                          // Capture: start of the pass
+    for (i = 0; i < lm75Count; i++)
+    {
+        if (lm75ReadRaw(&lm75s[i].dev, (lm75s[i].addr << 1) | 1, &raw) != I2C_OK)
+            continue;
+        t8 = (S16)raw >> 5;                                 // Signed 11-bit value, 1/8 C
+        lm75s[i].t8 = t8;
+        if (t8 < lo) lo = t8;
+        if (t8 > hi) hi = t8;
+        sum += t8;
+        lm75Valid++;
+    }
+    lm75PassTicks = pcaNow() - t0;                          // Capture: end of the pass
+    if (lm75Valid)
+    {
+        lm75Min8 = lo;
+        lm75Max8 = hi;
+        lm75Avg8 = (S16)(sum / lm75Valid);
+    }
+    return lm75Valid;
+}
+
+/*
+ * lm75AlarmAll(): setTempAlarm() for every sensor -> shared O.S. = "hottest >= threshold".
  * Returns:
- *   float  Temperature in degrees Celsius (C)
+ *   I2C_OK, or the status of the first sensor that could not be programmed
  */
-float readTemp(U8 add)
+U8 lm75AlarmAll(S8 threshold)
 {
-    float temp;                             // Variable to store the calculated temperature
-    startI2c();                             // Send I2C START condition
-    if(!writeByteI2c(add))                  // Send LM75 IC address (read mode), wait for ACK
-        temp = (((readByteI2c(0) << 8)      // Read MSB (first byte) and shift to upper bits Most Significant Bit/Byte 
-               + readByteI2c(1))            // Read LSB (second byte, only bit 7 is relevant) Least Significant Bit/Byte
-               >> 5) * 0.125;               // Extract 9-bit value (right-shift by 5), then multiply by resolution (0.125C/LSB)
-    stopI2c();                              // Send I2C STOP condition
-    return temp;                            // Return temperature as float
+    U8 i, st, first = I2C_OK;
+    for (i = 0; i < lm75Count; i++)
+    {
+        st = setTempAlarm(&lm75s[i].dev, lm75s[i].addr << 1, threshold);
+        if (first == I2C_OK) first = st;
+    }
+    return first;
 }
 
 // ---------- DS1307 RTC FUNCTIONS (logical read pipeline order) ----------
@@ -217,49 +789,123 @@ float readTemp(U8 add)
 U8 bcdToDec(U8 val);               // Prototype for BCD->DEC conversion
 U8 decToBcd(U8 val);               // Prototype for DEC->BCD conversion
 
+// ---- DS1307 NVRAM map (56 battery-backed bytes, 0x08..0x3F, raw via the burst functions) ----
+#define NV_TRIM         0x08       // 0x08..0x0C shadow clock trim record (shadow_clock.h)
+#define NV_THRESHOLD    0x0D       // 0x0D..0x0E TEMP_THRESHOLD, its complement (validity check)
+#define NV_RAIN         0x0F       // 0x0F..0x14 rain delay, skip state, event index (rain.h)
+#define NV_SUPER        0x15       // 0x15..0x18 watchdog resets, last missed task (supervisor.h)
+#define NV_FLOW         0x19       // 0x19..0x23 today's / yesterday's / window water volume (flow.h)
+#define NV_SERVO        0x24       // 0x24..0x35 servo end-point calibration (servo.h)
+
+// --------------------------------------------------------------------
+// [Init/Write] writeDS1307Burst(): write `count` consecutive registers in one transaction
+// IC: START -> [0xD0 W] -> [reg] -> [data 0] -> ... -> [data count-1] -> STOP
+//   - The pointer is sent once; the DS1307 auto-increments it after every byte
+//     (0x3F wraps to 0x00), so a time set is atomic: no rollover between fields.
+//   - Bytes are written raw (clock registers must already be BCD; NVRAM any value).
+// Returns I2C_OK, or the status of the last failed attempt
+U8 writeDS1307Burst(U8 addr, U8 *buf, U8 count)
+{
+    bit ack;                                       // Track NACK occurrence (1 = NACK seen)
+    U8 i, st, attempt = 0;
+    I2C_SLOW();                                    // DS1307: 100 kHz only
+    do {
+        ack = 1;
+        startI2c();                                // START condition
+        if (!writeByteI2c(0xD0))                   // Send address+W (0xD0), check ACK (0=ACK)
+        {
+            ack = writeByteI2c(addr);              // Send first register address
+            for (i = 0; i < count && !ack; i++)
+                ack = writeByteI2c(buf[i]);        // Stream the data bytes
+        }
+        stopI2c();                                 // STOP condition
+        st = i2cResult(ack);
+    } while (i2cRetry(&rtcDev, st, attempt++));
+    I2C_FAST();
+    return st;                                     // I2C_OK if full ACK path
+}
+
 // --------------------------------------------------------------------
 // [Init/Write] writeDS1307(): write one DS1307 register (decimal in)
 // IC: START -> [0xD0 W] -> [reg] -> [data(BCD)] -> STOP
-bit writeDS1307(U8 addr, U8 value)
+// Returns I2C_OK, or the status of the last failed attempt
+U8 writeDS1307(U8 addr, U8 value)
 {
-    bit ack = 1;                                   // Track NACK occurrence (1 = NACK seen)
-    startI2c();                                    // START condition
-    if (!writeByteI2c(0xD0))                       // Send address+W (0xD0), check ACK (0=ACK)
-    {
-        ack = writeByteI2c(addr);                  // Send target register address
-        ack = writeByteI2c(decToBcd(value));       // Send data (converted to BCD)
-    }
-    stopI2c();                                     // STOP condition
-    return ack;                                    // Return 0 if full ACK path, else 1
+    U8 bcd = decToBcd(value);                      // Data converted to BCD
+    return writeDS1307Burst(addr, &bcd, 1);
 }
 
 // --------------------------------------------------------------------
 // [Step 1+2] readDS1307(): read one register then return DECIMAL
 // IC: START->[0xD0 W]->[reg]->STOP->START->[0xD1 R]->read+NACK->STOP
-U8 readDS1307(U8 addr)
+// value receives the decimal register value only on I2C_OK (last good value kept otherwise)
+U8 readDS1307(U8 addr, U8 *value)
 {
+    bit ack;
+    U8 st, attempt = 0;
     U8 dataVal = 0;                                // Raw BCD storage
-    startI2c();                                    // START condition
-    if (!writeByteI2c(0xD0))                       // Address+W (ACK expected)
-    {
-        writeByteI2c(addr);                        // Send register pointer (0x00..0x07)
-        stopI2c();                                 // STOP to latch internal pointer
-        startI2c();                                // START again (read phase)
-        writeByteI2c(0xD1);                        // Address+R (0xD1)
-        dataVal = readByteI2c(1);                  // Read one byte; send NACK (last byte)
-    }
-    stopI2c();                                     // STOP condition
+    I2C_SLOW();                                    // DS1307: 100 kHz only
+    do {
+        ack = 1;
+        startI2c();                                // START condition
+        if (!writeByteI2c(0xD0) && !writeByteI2c(addr)) // Address+W, register pointer (0x00..0x07)
+        {
+            stopI2c();                             // STOP to latch internal pointer
+            startI2c();                            // START again (read phase)
+            ack = writeByteI2c(0xD1);              // Address+R (0xD1)
+            if (!ack)
+                dataVal = readByteI2c(1);          // Read one byte; send NACK (last byte)
+        }
+        stopI2c();                                 // STOP condition
+        st = i2cResult(ack);
+    } while (i2cRetry(&rtcDev, st, attempt++));
+    I2C_FAST();
+    if (st != I2C_OK) return st;                   // Keep the caller's last good value
     if (addr == 0) dataVal &= 0x7F;                // Clear CH bit if reading seconds
-    return bcdToDec(dataVal);                      // [Step 3] Convert BCD->DEC and return
+    *value = bcdToDec(dataVal);                    // [Step 3] Convert BCD->DEC
+    return I2C_OK;
 }
 
 // --------------------------------------------------------------------
-// [Init/Write] setupTime(): write HH:MM:SS (decimal inputs)
-void setupTime(U8 hour, U8 minute, U8 second)
+// [Step 1+2] readDS1307Burst(): read `count` consecutive raw registers
+// IC: START->[0xD0 W]->[reg]->STOP->START->[0xD1 R]->data (ACK ... NACK last)->STOP
+//   - The DS1307 copies the clock into its read buffer at START, so the fields
+//     of one burst always belong to the same second.
+// buf receives raw bytes (BCD, CH bit included) only on I2C_OK
+U8 readDS1307Burst(U8 addr, U8 *buf, U8 count)
 {
-    writeDS1307(0x02, hour);                       // Write hours register (0x02)
-    writeDS1307(0x01, minute);                     // Write minutes register (0x01)
-    writeDS1307(0x00, second);                     // Write seconds register (0x00)
+    bit ack;
+    U8 i, st, attempt = 0;
+    I2C_SLOW();                                    // DS1307: 100 kHz only
+    do {
+        ack = 1;
+        startI2c();                                // START condition
+        if (!writeByteI2c(0xD0) && !writeByteI2c(addr)) // Address+W, register pointer
+        {
+            stopI2c();                             // STOP to latch internal pointer
+            startI2c();                            // START again (read phase)
+            ack = writeByteI2c(0xD1);              // Address+R (0xD1)
+            for (i = 0; i < count && !ack; i++)
+                buf[i] = readByteI2c(i == count - 1); // ACK all but the last byte (NACK)
+        }
+        stopI2c();                                 // STOP condition
+        st = i2cResult(ack);
+    } while (i2cRetry(&rtcDev, st, attempt++));
+    I2C_FAST();
+    return st;
+}
+
+// --------------------------------------------------------------------
+// [Init/Write] setupTime(): write HH:MM:SS (decimal inputs) in one burst
+// Seconds go first with CH = 0: the oscillator runs and the DS1307 restarts its
+// 1 Hz divider on the seconds write, so the new time starts on a whole second.
+U8 setupTime(U8 hour, U8 minute, U8 second)
+{
+    U8 t[3];
+    t[0] = decToBcd(second);                       // 0x00 seconds (CH = 0)
+    t[1] = decToBcd(minute);                       // 0x01 minutes
+    t[2] = decToBcd(hour);                         // 0x02 hours (24 h mode)
+    return writeDS1307Burst(0x00, t, 3);
 }
 
 // --------------------------------------------------------------------
@@ -275,24 +921,205 @@ void printTime(U8 hour, U8 minute, U8 second)
 // [Step 3 helpers] bcdToDec(): convert 8-bit BCD to decimal (0..99)
 U8 bcdToDec(U8 val)
 {
+#if LUT_BCD
+    return bcdDecTable[val];                       // Generated table (lut_tables.h)
+#else
     return ((val >> 4) * 10)                       // Upper nibble -> tens
          + (val & 0x0F);                           // Lower nibble -> units
+#endif
 }
 // [Init/Write helper] decToBcd(): convert decimal (0..99) to 8-bit BCD
 U8 decToBcd(U8 val)
 {
+#if LUT_BCD
+    return decBcdTable[val];                       // Generated table (lut_tables.h)
+#else
     return ((val / 10) << 4)                       // Tens into upper nibble
          | (val % 10);                              // Units into lower nibble
+#endif
 }
 
+#if I2C_BENCH
+// ---------- IC BENCH MODE ----------
+// Measures what the timing profile actually achieves on the target:
+//   - The PCA0 counter (SYSCLK / 12 = 4 MHz, 0.25 s per tick) is captured before
+//     and after each transaction; one transaction is far below the 16.384 ms
+//     counter period, so a 16-bit unsigned difference is always correct.
+//   - sclHigh()/byte functions count SCL clocks and bytes while the bench runs.
+//   - SCL frequency  = clocks  4 MHz / ticks,  throughput = bytes  4 MHz / ticks.
+// Interrupts stay enabled, so the figures include real ISR interference.
+#define I2C_BENCH_REPS  16          // Transactions per device per bench run
+#define I2C_BENCH_LM75  0           // Result index: LM75 temperature read (3 bytes)
+#define I2C_BENCH_RTC   1           // Result index: DS1307 single-register read (4 bytes)
+
+typedef struct
+{
+    U16 sclKhz;                     // Achieved SCL frequency (kHz)
+    U16 bytesPerSec;                // Effective throughput incl. address/pointer bytes
+} I2cBenchResult;
+
+I2cBenchResult i2cBenchResult[2];
+
+/*
+ * i2cBench(): Runs I2C_BENCH_REPS transactions against one device and stores
+ *             the achieved SCL frequency and byte rate in i2cBenchResult[dev].
+ * Parameters:
+ *   dev - I2C_BENCH_LM75 or I2C_BENCH_RTC
+ */
+void i2cBench(U8 dev)
+{
+    U32 ticks = 0;
+    U16 t0;
+    U8 i, rtcVal;
+    float t;
+    i2cClocks = 0;
+    i2cBytes = 0;
+    for (i = 0; i < I2C_BENCH_REPS; i++)
+    {
+        t0 = pcaNow();                                  // Capture: start of transaction
+        if (dev == I2C_BENCH_LM75)
+            readTemp((LM75_ADDR << 1) | 1, &t);
+        else
+            readDS1307(0x00, &rtcVal);
+        ticks += (U16)(pcaNow() - t0);                  // Capture: end of transaction
+    }
+    if (ticks == 0) ticks = 1;
+    i2cBenchResult[dev].sclKhz      = (U16)(((U32)i2cClocks * 4000UL) / ticks);
+    i2cBenchResult[dev].bytesPerSec = (U16)(((U32)i2cBytes * 4000000UL) / ticks);
+}
+#endif
+
 // ---------- ADC FUNCTION ---------- Analog-to-Digital Converter
+
+// ---------- ADC0 WINDOW COMPARE (soil threshold in hardware) ----------
+// Every soil conversion of the excitation pipeline (below) is started by Timer3 (AD0CM = 101).
+// The window detector compares every result against ADC0GT/ADC0LT and raises AD0WINT
+// only when the result lies in the programmed region, so the CPU sees soil crossings only:
+//   - soil wet (soilDry = 0): wait for ADC0 >= threshold -> GT = thr - 1, LT = 0
+//     (LT < GT -> "outside" mode: interrupt if ADC0 < 0 (never) or ADC0 > thr - 1)
+//   - soil dry (soilDry = 1): wait for ADC0 <  threshold -> GT = 0x3FF, LT = thr
+//     (LT < GT -> "outside" mode: interrupt if ADC0 < thr or ADC0 > 1023 (never))
+// After each crossing the ISR flips soilDry and re-arms the window for the opposite edge.
+#define SOIL_CHANNEL    0x01    // P2.1 = soil moisture probe
+#define ADC_SCAN_CM     0x05    // ADC0CN.AD0CM = 101 -> conversion start on Timer3 overflow
+#define ADC_CM_MASK     0x07    // ADC0CN.AD0CM bit field
+#define EWADC0          0x04    // EIE1 bit 2 -> ADC0 window compare interrupt enable
+#define EADC0           0x08    // EIE1 bit 3 -> ADC0 end-of-conversion interrupt enable
+#define ET3             0x80    // EIE1 bit 7 -> Timer3 interrupt enable
+
+bit soilDry = 0;                // Soil state maintained by the window ISR (1 = raw >= threshold)
+U16 soilRawThreshold = 0x3FF;   // Window threshold in raw ADC counts (set by setSoilWindow)
+U16 soilEdges = 0;              // Number of window crossings (ISR entries) since reset
+U32 adcSuppressed = 0;          // Loops in which the sampling policy did not ask for a soil sample
+
+// ---------- SOIL PROBE EXCITATION PIPELINE (Timer3 -> ADC0) ----------
+// The resistive probe is powered from P1.2 (P1.3 = return) only around its conversions:
+// powered continuously it corrodes and draws current between the sparse samples.
+//   [idle]    Timer3 ticks every 10 ms, AD0CM = 000 (no conversions), probe off
+//   [excite]  soilRequest() pending: P1.2 HIGH, Timer3 restarted for soilSettleUs and
+//             AD0CM = 101 -> the overflow that ends the settle window starts the
+//             conversion in hardware (no interrupt latency inside the settle time)
+//   [convert] End-of-conversion ISR: AD0CM = 000, probe reversed (SOIL_ALTERNATE: the
+//             same on-time with P1.3 HIGH -> no net DC through the soil) or off; result
+//             in soilRaw, compared by the window detector on the way (soilDry)
+//   [balance] Next Timer3 overflow: probe off, back to 10 ms ticks
+// On-time per sample: settle + one conversion (twice that with SOIL_ALTERNATE).
+// soilSettleUs is measured at boot (soilCalibrate()): shortest window after which the
+// reading matches a long-settled one.
+#define SOIL_EXC_FWD    0x04    // P1.2: probe excitation (HIGH while measuring)
+#define SOIL_EXC_RET    0x08    // P1.3: probe return (HIGH while reversed)
+#define SOIL_ALTERNATE  1       // 1 = reverse the excitation after each sample (charge balance)
+#define SOIL_CAL_MAX_US 4000    // Longest settle window tried by soilCalibrate() (reference)
+#define T3_TICK_RELOAD  0x63C0  // Timer3 reload for the 10 ms idle tick (65536 - 40000)
+
+#define SOIL_IDLE       0       // soilStage values
+#define SOIL_SETTLE     1
+#define SOIL_CONVERT    2
+#define SOIL_BALANCE    3
+
+U8  soilStage = SOIL_IDLE;      // Pipeline stage (Timer3 / ADC0 ISRs)
+bit soilRequested = 0;          // 1 = a sample was requested, excitation at the next Timer3 tick
+bit soilRunning = 0;            // 1 once soilStart() enabled the pipeline interrupts
+U16 soilSettleUs = SOIL_CAL_MAX_US; // Settle window (s), set by soilCalibrate()
+U16 soilSettleReload = (U16)(0 - SOIL_CAL_MAX_US * 4);  // Timer3 reload for the settle window (65536 - 4  soilSettleUs)
+volatile U16 soilRaw = 0;       // Last conversion of the powered probe (0..1023)
+volatile U8 soilSeq = 0;        // Incremented with every new soilRaw
+U8  soilTaken = 0;              // soilSeq of the last soilTake()
+U16 soilMissed = 0;             // Samples lost (no end of conversion within a settle window)
+
+#define SOIL_PROBE_OFF()    { P1 &= ~(SOIL_EXC_FWD | SOIL_EXC_RET); }   // ANL/ORL: latch read-modify-write,
+#define SOIL_PROBE_FWD()    { P1 &= ~SOIL_EXC_RET; P1 |= SOIL_EXC_FWD; } // the IC pins on P1 are untouched
+#define SOIL_PROBE_REV()    { P1 &= ~SOIL_EXC_FWD; P1 |= SOIL_EXC_RET; }
+// Restarts Timer3 with a new period (reload written as well: it repeats)
+#define T3_RESTART(r)       { TMR3CN &= ~0x04; TMR3RLL = (U8)(r); TMR3RLH = (U8)((r) >> 8); \
+                              TMR3L = (U8)(r); TMR3H = (U8)((r) >> 8); TMR3CN |= 0x04; }
+
+/*
+ * soilHold(): Takes the ADC away from the pipeline for a software conversion.
+ * Waits until no soil sample is in flight (at most two settle windows), then masks
+ * the pipeline and window interrupts; soilRelease() gives them back.
+ */
+void soilHold(void)
+{
+    for (;;)
+    {
+        EIE1 &= ~(EWADC0 | EADC0 | ET3);
+        if (soilStage != SOIL_SETTLE && soilStage != SOIL_CONVERT) return;
+        EIE1 |= EWADC0 | EADC0 | ET3;   // Let the running sample finish
+    }
+}
+
+void soilRelease(void)
+{
+    EIE1 |= EWADC0;                     // Crossing interrupts on
+    if (soilRunning) EIE1 |= EADC0 | ET3;
+}
+
+// adcConvert(): One software conversion (caller holds the ADC: soilHold()).
+int adcConvert(U8 channelSelect)
+{
+    int result;
+    while(AD0BUSY);           // Let a running conversion finish first
+    AMX0P = channelSelect;    // Select the ADC input channel (via analog multiplexer)
+    waitUs(ADC_SETTLE_US);            // Short delay to allow input voltage to settle (timer-based)
+    AD0INT = 0;               // Discard the completion flag of the last pipeline conversion
+    AD0BUSY = 1;              // Initiate ADC conversion
+    while(!AD0INT);           // Wait until conversion is finished (AD0INT = 1)
+    AD0INT = 0;               // Clear conversion complete flag
+    result = ADC0;            // 10-bit result from ADC0 register
+    AMX0P = SOIL_CHANNEL;     // Hand the multiplexer back to the soil pipeline
+    AD0WINT = 0;              // This result was compared against the soil window -> ignore it
+    return result;            // Return 10-bit result
+}
+
+// Program the window registers for the crossing opposite to the current soilDry state.
+// Macro (not a function) so both the ISR and setSoilWindow() can use it without a
+// shared non-reentrant call.
+#define SOIL_WINDOW_ARM()                                               \
+    if (soilDry) {                      /* dry -> wait for ADC0 < thr  */ \
+        ADC0GTH = 0x03; ADC0GTL = 0xFF;                                 \
+        ADC0LTH = soilRawThreshold >> 8; ADC0LTL = soilRawThreshold;    \
+    } else {                            /* wet -> wait for ADC0 >= thr */ \
+        ADC0GTH = (soilRawThreshold - 1) >> 8;                          \
+        ADC0GTL = (soilRawThreshold - 1);                               \
+        ADC0LTH = 0x00; ADC0LTL = 0x00;                                 \
+    }
+
+// ADC_PCT(): ADC count (0..1023) -> percent (0..100), table or arithmetic (LUT_ADC_PCT).
+#if LUT_ADC_PCT
+#define ADC_PCT(raw)    adcPctTable[raw]
+#else
+#define ADC_PCT(raw)    ((U8)(((raw) * ADC_PCT_NUM) / ADC_PCT_DEN))
+#endif
+
 /*
  * ADC_IN_CHANNEL(): Performs an analog-to-digital conversion on the selected ADC input channel.
  * * Parameters:
  *   channelSelect  ADC channel number (e.g., 0x00 = P2.0, 0x01 = P2.1, etc.)
  * Process:
+ *   - Waits until no soil pipeline sample is in flight and masks the pipeline (soilHold).
  *   - Sets AMX0P to select the desired analog input channel.
- *   - Waits briefly (delay_us) to allow the input voltage to stabilize.
+ *   - Waits briefly (waitUs, PCA counter) to allow the input voltage to stabilize.
  *   - Starts the ADC conversion by setting AD0BUSY.
  *   - Waits until AD0INT is set, indicating conversion complete.
  *   - Clears the AD0INT flag.
@@ -301,80 +1128,160 @@ U8 decToBcd(U8 val)
  */
 int ADC_IN_CHANNEL(U8 channelSelect)
 {
-    AMX0P = channelSelect;    // Select the ADC input channel (via analog multiplexer)
-    delay_us(usec);           // Short delay to allow input voltage to settle
-    AD0BUSY = 1;              // Initiate ADC conversion
-    while(!AD0INT);           // Wait until conversion is finished (AD0INT = 1)
-    AD0INT = 0;               // Clear conversion complete flag
-    return ADC0;              // Return 10-bit result from ADC0 register
-}
-// ---------- Servo PWM Function ----------Pulse Width Modulation
-// pulse(): Generates a precise PWM signal using PCA Module 0 to control servo angle.
-// OVERVIEW:
-// ----------------------------------------------------
-// - The PCA (Programmable Counter Array) operates at 4 MHz 
-//   (derived from SYSCLK  12 = 48 MHz  12).
-//   -> Each PCA tick = 0.25 microseconds.
-// - To create a pulse of `w` microseconds (s):
-//   -> Convert pulse width to ticks by multiplying by 4 (since 1 s = 4 ticks),
-//     then apply 2's complement (negate the result) for proper compare logic.
-//  -> Formula: width_ticks = -4  w
-//    Example:
-//       w = 1500 s
-//       -> width_ticks = -4  1500 = -6000
-//       -> 2s complement of -6000 = 0xE890 (decimal: 59536)
-// WHY NEGATIVE?
-// - The PCA counter always counts **upward** from 0 to 65535.
-// - We load a **twos complement negative value** (e.g., -6000 = 0xE890).
-// - When the PCA counter reaches this value (e.g., 59536), a **compare match** occurs.
-//  -> PCA sets output LOW at that exact tick -> pulse ends with precision.
-// PHYSICAL BEHAVIOR:
-// ----------------------------------------------------
-// - Output pin goes HIGH at start of pulse.
-// - PCA counter starts counting from 0.
-// - When match value is reached -> pin goes LOW.
-// - The remainder of the 20ms cycle stays LOW.
-// PULSE WIDTH -> PCA VALUE (TICK) CONVERSION:
-// ----------------------------------------------------
-// Each value below passes through 3 stages:
-//   1. s width (input)
-//   2. (-4) -> tick count (signed int16)
-//   3. 2's complement -> HEX -> final value loaded into PCA
-//   600 s -> -2400   -> 2's Comp = 63168  -> HEX = 0xF6C0  -> 0
-//  1500 s -> -6000   -> 2's Comp = 59536  -> HEX = 0xE890  -> 90
-//  2400 s -> -9600   -> 2's Comp = 55936  -> HEX = 0xDA80  -> 180
-// - In each step, we increase or decrease the angle by 30 s ( = 120 ticks ).
-//    -> Total movement from 600 to 2400 = 1800 s -> 1800 / 30 = 60 steps
-//    -> Full sweep (up + down) = 120 steps total
-// - Each pulse is sent every 20ms (delay_ms(20))
-//    -> Full sweep takes 120  20ms = 2400ms 
-// - The 30s step size was chosen to:
-///    -> Ensure smooth motion
-//     ->Avoid delay accumulation
-//     -> Allow precise, visible servo motion without jitter
-// REGISTERS USED:
-// ----------------------------------------------------
-// - PCA0CPL0 -> Capture Low Byte  (bits 07 of compare value)
-// - PCA0CPH0 -> Capture High Byte (bits 815)
-// - Together form a full 16-bit match register.
-// REMARK:
-// ----------------------------------------------------
-// - `width` is clamped between 6002400 s to avoid unstable angles.
-// - No interrupt is needed  PCA handles the match and pin toggle automatically.
-void pulse(U16 width)
-{
-    if (width < 600) width = 600;         // Limit minimum pulse width to 600 s (0)
-                                          // -> Protection: Prevents sending too narrow pulse, which could cause servo jitter or fail to respond
-    else if (width > 2400) width = 2400;  // Limit maximum pulse width to 2400 s (180)
-                                          // -> Protection: Prevents over-driving the servo beyond safe range, which may damage internal gears
-    width = -4 * width;                   // Convert microseconds to PCA ticks (negative for compare match logic) 
-    PCA0CPL0 = width & 0xFF;              // Load lower 8 bits of match value to PCA0CPL0   (bits 07 of compare value)
-                                          // Example: for width = 1500 -> -6000 -> 0xE890 -> LSB = 0x90        
-    PCA0CPH0 = (width >> 8);              // Load upper 8 bits to PCA0CPH0  Capture High Byte (bits 815)
-                                          // Example: MSB = 0xE8 for 1500 s pulse 	// the pca convert them to one adress of 16 
-	                                        //  bits to compare word again  Together form a full 16-bit match register.
+    int result;
+    soilHold();               // Not during a soil sample; pipeline and window interrupts masked
+    result = adcConvert(channelSelect);
+    soilRelease();            // Re-enable crossing / pipeline interrupts
+    return result;            // Return 10-bit result
+}
+
+/*
+ * soilReadAt(): One software reading of the probe, powered for `settleUs` first
+ * (boot calibration, setSoilWindow()). Balanced like a pipeline sample.
+ */
+int soilReadAt(U16 settleUs)
+{
+    int r;
+    soilHold();
+    SOIL_PROBE_FWD();
+    waitUs(settleUs);
+    r = adcConvert(SOIL_CHANNEL);
+#if SOIL_ALTERNATE
+    SOIL_PROBE_REV();
+    waitUs(settleUs);
+#endif
+    SOIL_PROBE_OFF();
+    soilRelease();
+    return r;
+}
+
+/*
+ * soilCalibrate(): Measures the settle window at boot (before soilStart()).
+ * Reference = reading after SOIL_CAL_MAX_US; the window is the shortest of
+ * 25, 50, 100, ... s whose reading lies within 2 counts of it, doubled as margin.
+ */
+void soilCalibrate(void)
+{
+    int ref = soilReadAt(SOIL_CAL_MAX_US), d;
+    U16 t;
+    for (t = 25; t < SOIL_CAL_MAX_US; t <<= 1)
+    {
+        d = soilReadAt(t) - ref;
+        if (d >= -2 && d <= 2) break;
+    }
+    t <<= 1;
+    soilSettleUs = t > SOIL_CAL_MAX_US ? SOIL_CAL_MAX_US : t;
+    soilSettleReload = (U16)(0 - (soilSettleUs << 2));   // 4 Timer3 ticks per s
+}
+
+// soilStart(): Starts the pipeline (after soilCalibrate() and setSoilWindow()).
+void soilStart(void)
+{
+    soilRunning = 1;
+    EIE1 |= EADC0 | ET3;
 }
 
+// soilRequest(): Asks for a soil sample (ignored while one is in flight or not taken yet).
+void soilRequest(void)
+{
+    if (soilStage == SOIL_IDLE && soilSeq == soilTaken)
+        soilRequested = 1;
+}
+
+/*
+ * soilTake(): Hands over a new pipeline sample.
+ * Returns:
+ *   1 = *raw holds a sample not taken before, 0 = none yet
+ * soilRaw is not rewritten before the next soilRequest(), so no masking is needed.
+ */
+bit soilTake(S16 *raw)
+{
+    if (soilSeq == soilTaken) return 0;
+    soilTaken = soilSeq;
+    *raw = soilRaw;
+    return 1;
+}
+
+/*
+ * setSoilWindow(): (Re)programs the soil window from a calibrated raw threshold.
+ *   - Takes one software conversion to find which side of the threshold the soil
+ *     is on now, then arms the window for the opposite crossing.
+ *   - Call on boot and whenever the soil threshold changes.
+ * Parameters:
+ *   raw - threshold in ADC counts (1..1023); soil is "dry" when ADC0 >= raw
+ */
+void setSoilWindow(U16 raw)
+{
+    if (raw == 0) raw = 1;                              // GT = raw - 1 must not underflow
+    EIE1 &= ~EWADC0;                                    // No crossings while the window is rewritten
+    soilRawThreshold = raw;
+    soilDry = (soilReadAt(soilSettleUs) >= raw);        // Current side of the threshold (probe powered)
+    EIE1 &= ~EWADC0;                                    // soilReadAt re-enabled it; keep masked
+    SOIL_WINDOW_ARM();                                  // Wait for the opposite crossing
+    AD0WINT = 0;                                        // Drop any compare made against the old window
+    EIE1 |= EWADC0;                                     // Crossing interrupts on
+}
+
+// ADC0 window compare ISR: runs only when the soil reading crosses the threshold.
+#ifndef SIM_HOST
+void ADC0_Window_ISR(void) interrupt 9 using ISR_BANK_LO
+{
+    ISR_IN(ISR_WIN)
+    AD0WINT = 0;                // Acknowledge window compare flag
+    soilDry = !soilDry;         // Crossing -> soil changed side
+    SOIL_WINDOW_ARM();          // Wait for the next (opposite) crossing
+    soilEdges++;                // Diagnostics: number of crossings
+    ISR_OUT(ISR_WIN);
+}
+
+// Timer3 overflow: soil pipeline clock (10 ms idle tick, settle window while sampling).
+void Timer3_ISR(void) interrupt 14 using ISR_BANK_LO
+{
+    ISR_IN(ISR_T3)
+    TMR3CN &= ~0x80;            // TF3H is not cleared by hardware
+    switch (soilStage)
+    {
+    case SOIL_IDLE:
+        if (!soilRequested) break;
+        soilRequested = 0;
+        SOIL_PROBE_FWD();       // Excite
+        T3_RESTART(soilSettleReload);
+        ADC0CN |= ADC_SCAN_CM;  // The overflow that ends the settle window starts the conversion
+        soilStage = SOIL_SETTLE;
+        break;
+    case SOIL_SETTLE:           // This overflow started the conversion; ADC0_EOC_ISR goes on
+        soilStage = SOIL_CONVERT;
+        break;
+    case SOIL_CONVERT:          // No end of conversion within a settle window: sample lost
+        ADC0CN &= ~ADC_CM_MASK;
+        soilMissed++;
+        // no break: power off as after a sample
+    case SOIL_BALANCE:
+        SOIL_PROBE_OFF();
+        T3_RESTART(T3_TICK_RELOAD);
+        soilStage = SOIL_IDLE;
+        break;
+    }
+    ISR_OUT(ISR_T3);
+}
+
+// ADC0 end of conversion: only pipeline conversions get here (software ones are masked).
+void ADC0_EOC_ISR(void) interrupt 10 using ISR_BANK_LO
+{
+    ISR_IN(ISR_EOC)
+    AD0INT = 0;
+    ADC0CN &= ~ADC_CM_MASK;     // No further conversions until the next excitation
+#if SOIL_ALTERNATE
+    SOIL_PROBE_REV();           // Same on-time reversed until the next Timer3 overflow
+#else
+    SOIL_PROBE_OFF();
+#endif
+    soilRaw = ADC0;
+    soilSeq++;
+    soilStage = SOIL_BALANCE;
+    ISR_OUT(ISR_EOC);
+}
+#endif
 // ---------- Relay Control Functions ----------
 // This module controls a 5V relay (low-side switching via NPN transistor).
 // MCU pin P0.2 sends a 3.3V logic signal to the relay module's IN pin.
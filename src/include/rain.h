@@ -0,0 +1,149 @@
+// ================== rain.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Rain integrator and rain delay: skips the next watering windows after rain.
+// ----------------------------------------------------------
+// [1] Integrator:
+//     -> rainSample(): called with every rain sample the sampling policy takes;
+//        adds wetness  time since the previous sample (clockNow()) to the index
+//        of the current rain event (wet-minutes, see site_config.h)
+//     -> Cost per sample: one 1616 multiply, one 32-bit add and compare
+// [2] Rain Events:
+//     -> An event ends after RAIN_GAP_MS without wetness, or when a window opens
+//        while it is still running; its index becomes the rain delay
+//        (index / RAIN_WET_MIN_PER_WINDOW windows, never shortening a pending delay)
+// [3] Window Skipping:
+//     -> rainWindowTick(): called every loop with "inside a window now"; each window
+//        that opens while a delay is pending is skipped as a whole (rainSkipping)
+// [4] Persistence:
+//     -> Delay, skip state and the running event index in DS1307 NVRAM (NV_RAIN),
+//        written when one of them changes (at most once per wet-minute)
+// The instantaneous check in runProject (rain < RAIN_THRESHOLD) stays: this only
+// adds the windows after the sensor has dried.
+
+// ---------- [1] Integrator ----------
+#define RAIN_DRY_PCT    90      // Readings at or above this are dry (a dry board reads ~95..100 %)
+#define RAIN_UNIT       (RAIN_DRY_PCT * 60000UL)  // One wet-minute: 1 min at reading 0 % (wetness  ms)
+#define RAIN_DT_MAX_MS  60000UL // Longest gap credited between two samples
+#define RAIN_GAP_MS     (30 * 60000UL)  // Dry time that ends a rain event
+
+U16 rainIndex = 0;              // Wet-minutes of the current (or last finished) event
+U32 rainAcc = 0;                // Fraction of the next wet-minute (wetness  ms)
+U32 rainLastMs = 0;             // clockNow() of the previous sample
+U32 rainDryMs = 0;              // Dry time since the last wet sample
+bit rainEvent = 0;              // 1 = an event is running (index still growing)
+U8  rainDelay = 0;              // Windows still to skip
+bit rainSkipping = 0;           // 1 = the current window is being skipped
+bit rainInWindow = 0;           // Previous rainWindowTick() input
+
+// ---------- [4] Persistence ----------
+#define NV_RAIN_LEN     6       // Magic, delay, flags, index LSB/MSB, checksum
+#define NV_RAIN_MAGIC   0xA7
+
+U8 nvRainSum(U8 *b)
+{
+    return (U8)~(b[0] + b[1] + b[2] + b[3] + b[4]);
+}
+
+void rainSave(void)
+{
+    U8 b[NV_RAIN_LEN];
+    b[0] = NV_RAIN_MAGIC;
+    b[1] = rainDelay;
+    b[2] = (rainEvent ? 1 : 0) | (rainSkipping ? 2 : 0);
+    b[3] = (U8)rainIndex;
+    b[4] = (U8)(rainIndex >> 8);
+    b[5] = nvRainSum(b);
+    writeDS1307Burst(NV_RAIN, b, NV_RAIN_LEN);
+}
+
+// rainLoad(): Restores the rain state at boot (blank/corrupt NVRAM -> no delay).
+void rainLoad(void)
+{
+    U8 b[NV_RAIN_LEN];
+    rainLastMs = clockNow();
+    if (readDS1307Burst(NV_RAIN, b, NV_RAIN_LEN) != I2C_OK) return;
+    if (b[0] != NV_RAIN_MAGIC || b[5] != nvRainSum(b)) return;
+    rainDelay = b[1] > RAIN_DELAY_MAX ? RAIN_DELAY_MAX : b[1];
+    rainEvent = b[2] & 1;
+    rainSkipping = (b[2] & 2) ? 1 : 0;          // Reset inside a skipped window: keep skipping it
+    rainInWindow = rainSkipping;
+    rainIndex = ((U16)b[4] << 8) | b[3];
+}
+
+// ---------- [2] Rain Events ----------
+// rainEventEnd(): Turns the finished event into a rain delay.
+void rainEventEnd(void)
+{
+    U16 n = rainIndex / RAIN_WET_MIN_PER_WINDOW;
+    if (n > RAIN_DELAY_MAX) n = RAIN_DELAY_MAX;
+    if (n > rainDelay) rainDelay = (U8)n;       // A pending longer delay is kept
+    rainEvent = 0;
+    rainAcc = 0;
+    rainSave();
+}
+
+// ---------- [1] Integrator ----------
+/*
+ * rainSample(): Integrates one rain sample.
+ * Parameters:
+ *   pct - rain reading in % (low = wet), as shown on the screens
+ */
+void rainSample(int pct)
+{
+    U32 t = clockNow();
+    U32 dt = t - rainLastMs;
+    rainLastMs = t;
+    if (dt > RAIN_DT_MAX_MS) dt = RAIN_DT_MAX_MS;
+    if (pct < 0) pct = 0;
+    if (pct >= RAIN_DRY_PCT)
+    {
+        if (!rainEvent) return;
+        rainDryMs += dt;
+        if (rainDryMs >= RAIN_GAP_MS) rainEventEnd();
+        return;
+    }
+    if (!rainEvent)                             // First wet sample: a new event starts
+    {
+        rainEvent = 1;
+        rainIndex = 0;
+        rainAcc = 0;
+    }
+    rainDryMs = 0;
+    rainAcc += (U32)(RAIN_DRY_PCT - pct) * dt;  // Wetness  time
+    if (rainAcc >= RAIN_UNIT)
+    {
+        rainAcc -= RAIN_UNIT;
+        if (rainIndex < 0xFFFF) rainIndex++;
+        rainSave();                             // At most once per wet-minute
+    }
+}
+
+// ---------- [3] Window Skipping ----------
+/*
+ * rainWindowTick(): Once per main-loop pass.
+ * Parameters:
+ *   inWindow - 1 while the time lies inside one of today's windows (planAllows)
+ * A window opening ends a running event first, so rain that stops just before a
+ * window already skips it.
+ */
+void rainWindowTick(bit inWindow)
+{
+    if (inWindow && !rainInWindow)              // A window opens
+    {
+        if (rainEvent) rainEventEnd();
+        if (rainDelay)
+        {
+            rainDelay--;
+            rainSkipping = 1;
+            rainSave();
+        }
+    }
+    else if (!inWindow && rainInWindow && rainSkipping)    // The skipped window closes
+    {
+        rainSkipping = 0;
+        rainSave();
+    }
+    rainInWindow = inWindow;
+}
@@ -0,0 +1,130 @@
+// ================== sample_policy.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Rate-adaptive sampling policy for the main-loop sensors.
+// ----------------------------------------------------------
+// [1] Sensor Indexes and Policy Record:
+//     -> One SamplePolicy per sensor (time, temp, soil, rain, light)
+// [2] Policy Table:
+//     -> Per-sensor min/base/max period (in main-loop passes of ~20 ms),
+//        "near threshold" band and "fast change" step
+// [3] Scheduling Functions:
+//     -> policyDue():    called once per loop, says whether the sensor is due
+//     -> policyUpdate(): called after a sample, adapts the period
+// [4] Statistics:
+//     -> Per-sensor sample count and average period (policyAvgMs)
+//
+// Policy (evaluated after every sample):
+//   - |value - threshold| <= band  -> period = minPeriod (decision point is close)
+//   - |value - last|      >= step  -> period = minPeriod (value is moving quickly)
+//   - otherwise (stable)           -> back off: period = basePeriod, then doubles up to maxPeriod
+// Decision equivalence:
+//   A threshold crossing can only be reached from inside the band, where the sensor
+//   is sampled every minPeriod loops. For the polled decision inputs (rain, light)
+//   minPeriod = 1, so the decision changes on exactly the same loop as with
+//   per-loop polling, provided the value moves less than `band` within maxPeriod
+//   loops (or at least `step` in one period, which also forces fast sampling).
+//   A value that jumps from outside the band across the threshold between two
+//   samples is seen at the next sample: the decision is late by at most
+//   period - 1 <= maxPeriod - 1 loops (99 loops = 1.98 s for rain and light).
+//   sim/i2c_sim.c [5] replays both cases against per-loop polling and asserts
+//   these bounds (0 loops for slow traces, <= 99 for a shower or a splash).
+//   Temp and soil decisions are made in hardware (LM75 O.S., ADC0 window); their
+//   samples only feed the display. Watering windows open and close on any minute
+//   (sunrise/sunset-relative edges), and the time sample is a shadow-clock read
+//   without IC, so time is sampled on every loop.
+
+// ---------- [1] Sensor Indexes ----------
+#define SENSOR_TIME     0       // Shadow-clock HH:MM:SS (trimmed to the DS1307)
+#define SENSOR_TEMP     1       // LM75 temperature (display value)
+#define SENSOR_SOIL     2       // Soil percentage (display value)
+#define SENSOR_RAIN     3       // Rain percentage (decision input)
+#define SENSOR_LIGHT    4       // Light percentage (decision input)
+#define SENSOR_COUNT    5
+
+#define LOOP_MS         20      // Main-loop pass period (paced on clockNow(), longer only when a pass overruns)
+
+typedef struct
+{
+    U8  minPeriod;      // Fastest period (loops): near threshold or fast change
+    U8  basePeriod;     // Nominal period (loops)
+    U8  maxPeriod;      // Slowest period (loops) when the value is stable
+    U8  band;           // |value - threshold| <= band -> near the decision point
+    U8  step;           // |value - last| >= step -> fast change (0 = disabled)
+    S16 threshold;      // Decision point the value is compared against
+    U8  period;         // Current period (loops)
+    U8  elapsed;        // Loops since the last sample (saturates at 255)
+    S16 last;           // Previously sampled value
+    U16 samples;        // Samples taken since reset
+    U32 periodSum;      // Sum of loops between samples (-> average period)
+} SamplePolicy;
+
+// ---------- [2] Policy Table ----------
+// elapsed starts at 255 so every sensor is sampled on the first loop.
+// Thresholds marked 0 are loaded from the firmware thresholds in main() at boot.
+//                                  min base max band step threshold      period elapsed
+SamplePolicy xdata policy[SENSOR_COUNT] = {
+    /* SENSOR_TIME  (minute) */    {  1,   1,   1,   0,   0, 0,             1,    255, 0, 0, 0 },
+    /* SENSOR_TEMP  (C)     */    {  5,  50, 250,   1,   1, 0,            50,    255, 0, 0, 0 },
+    /* SENSOR_SOIL  (%)      */    {  5,  50, 250,   5,   3, 0,            50,    255, 0, 0, 0 },
+    /* SENSOR_RAIN  (%)      */    {  1,  10, 100,  10,   5, 0,            10,    255, 0, 0, 0 },
+    /* SENSOR_LIGHT (%)      */    {  1,  10, 100,  10,   5, 0,            10,    255, 0, 0, 0 }
+};
+
+char code sensorName[SENSOR_COUNT][6] = { "Time", "Temp", "Soil", "Rain", "Light" };
+
+// ---------- [3] Scheduling Functions ----------
+/*
+ * policyDue(): Advances the sensor's loop counter by one pass.
+ * Returns:
+ *   1 = sample the sensor in this loop, 0 = skip it
+ */
+bit policyDue(U8 sensor)
+{
+    SamplePolicy xdata *p = &policy[sensor];
+    if (p->elapsed != 255) p->elapsed++;        // Saturating loop counter
+    return (p->elapsed >= p->period);           // Due once a full period has passed
+}
+
+/*
+ * policyUpdate(): Records a sample and chooses the next period.
+ * Parameters:
+ *   sensor - SENSOR_xxx index
+ *   value  - sampled value in the same unit as the policy threshold
+ */
+void policyUpdate(U8 sensor, S16 value)
+{
+    SamplePolicy xdata *p = &policy[sensor];
+    S16 dist  = value - p->threshold;           // Distance to the decision point
+    S16 delta = value - p->last;                // Change since the previous sample
+    if (dist  < 0) dist  = -dist;
+    if (delta < 0) delta = -delta;
+    if (p->samples == 0) delta = 0;             // First sample: no previous value to compare
+    if (p->samples != 0xFFFF)                   // Statistics freeze once the counter saturates
+    {
+        if (p->samples) p->periodSum += p->elapsed; // Loops since the previous sample
+        p->samples++;
+    }
+
+    if (dist <= p->band || (p->step && delta >= p->step))
+        p->period = p->minPeriod;               // Near threshold / moving -> sample fast
+    else if (p->period < p->basePeriod)
+        p->period = p->basePeriod;              // Calm again -> back to the nominal rate
+    else if (p->period > (p->maxPeriod >> 1))
+        p->period = p->maxPeriod;               // Stable -> slowest rate
+    else
+        p->period <<= 1;                        // Stable -> back off (double the period)
+
+    p->last = value;
+    p->elapsed = 0;
+}
+
+// ---------- [4] Statistics ----------
+// policyAvgMs(): Average time between samples in ms (0 until two samples exist).
+U16 policyAvgMs(U8 sensor)
+{
+    SamplePolicy xdata *p = &policy[sensor];
+    if (p->samples < 2) return 0;
+    return (U16)((p->periodSum * LOOP_MS) / (p->samples - 1));
+}
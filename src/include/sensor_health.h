@@ -0,0 +1,179 @@
+// ================== sensor_health.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Per-sensor health monitor: classifies faults from the samples the sampling
+// policy already takes (no extra sensor reads) and applies a fail-safe policy.
+// ----------------------------------------------------------
+// [1] Fault Classes (priority order):
+//     -> HEALTH_RAIL : HEALTH_CONFIRM samples in a row outside lo..hi
+//                      (open or shorted probe: ADC at 0 or 1023)
+//     -> HEALTH_STEP : HEALTH_CONFIRM rejected steps in a row (erratic input)
+//     -> HEALTH_STUCK: stuckMax identical samples in a row (frozen input)
+//     -> HEALTH_STALE: no sample for staleTicks loops (IC failing, age stamp)
+// [2] Step Filter:
+//     -> A change larger than stepMax is held back for one sample; the next sample
+//        confirms it (within stepMax of the new level) or counts as another step
+// [3] Fail-Safe Policy:
+//     -> FAIL_BLOCK : a faulty sensor stops watering
+//     -> FAIL_IGNORE: a faulty sensor is dropped from the decision (its condition
+//                     counts as met)
+// [4] Status Icons:
+//     -> One letter per sensor on the Project screen, redrawn only on a change:
+//        green = OK, yellow = fault (ignored), red = fault (blocking)
+// Units are those of the samples: raw ADC counts (0..1023) for soil/rain/light,
+// 1/8 C for the LM75 array (hottest sensor).
+
+// ---------- [1] Fault Classes ----------
+#define HEALTH_OK       0
+#define HEALTH_RAIL     1
+#define HEALTH_STEP     2
+#define HEALTH_STUCK    3
+#define HEALTH_STALE    4
+#define HEALTH_CONFIRM  3       // Consecutive bad samples before RAIL / STEP
+
+#define FAIL_BLOCK      0
+#define FAIL_IGNORE     1
+
+typedef struct
+{
+    S16 lo, hi;         // Plausible sample range (outside -> rail)
+    S16 stepMax;        // Largest plausible change between two samples (0 = off)
+    U8  stuckMax;       // Identical samples before STUCK (0 = off)
+    U16 staleTicks;     // Loops without a sample before STALE (> sampling maxPeriod)
+    U8  failsafe;       // FAIL_BLOCK / FAIL_IGNORE
+    U8  status;         // HEALTH_xxx
+    U8  rails;          // Consecutive samples outside lo..hi
+    U8  steps;          // Consecutive rejected steps
+    U8  same;           // Consecutive identical samples (saturates at 255)
+    U8  primed;         // 1 once a first sample was accepted (last is valid)
+    S16 last;           // Last accepted sample
+    S16 cand;           // Level of the last rejected step
+    U16 stamp;          // loopTicks of the last sample
+    U16 faults;         // OK -> fault transitions since reset
+} SensorHealth;
+
+// Soil: both rails mean an open/shorted probe, which would water forever or never
+// -> FAIL_BLOCK. Rain: a dry board sits at the top rail, so only the bottom rail
+// (shorted board) is checked; rain onset is a legitimate jump. Light: clouds make
+// legitimate jumps. Temp: steps over 5 C between samples are implausible; a
+// constant temperature is normal. Stuck limits leave room for a quiet ADC.
+// The time row is unused (the shadow clock cannot fail this way).
+//                                   lo      hi  step stuck stale  failsafe
+SensorHealth xdata health[SENSOR_COUNT] = {
+    /* SENSOR_TIME  (unused) */   { -32767, 32767,  0,   0,    0, FAIL_IGNORE },
+    /* SENSOR_TEMP  (1/8 C) */   {   -440,  1000, 40,   0, 1500, FAIL_IGNORE },   // -55..+125 C
+    /* SENSOR_SOIL  (raw)    */   {      3,  1020, 300, 250, 1000, FAIL_BLOCK  },
+    /* SENSOR_RAIN  (raw)    */   {      3,  1023,  0,   0, 1000, FAIL_IGNORE },
+    /* SENSOR_LIGHT (raw)    */   {      3,  1020,  0, 250, 1000, FAIL_IGNORE }
+};
+
+char code healthLetter[SENSOR_COUNT] = { 'C', 'T', 'S', 'R', 'L' };
+char code healthCode[5] = { '+', 'R', 'J', 'K', 'A' };  // OK, Rail, Jump, stucK, Age
+
+// healthSet(): Changes the status; counts OK -> fault transitions.
+void healthSet(SensorHealth xdata *h, U8 status)
+{
+    if (status != HEALTH_OK && h->status == HEALTH_OK) h->faults++;
+    h->status = status;
+}
+
+/*
+ * healthSample(): Classifies one sample (call right after the sensor was read).
+ * Parameters:
+ *   sensor - SENSOR_xxx index
+ *   value  - the sample, in the unit of the health table
+ * Returns:
+ *   1 = use the value, 0 = held back by the step filter (keep the previous value)
+ */
+bit healthSample(U8 sensor, S16 value)
+{
+    SensorHealth xdata *h = &health[sensor];
+    S16 d = value - h->last;
+    bit use = 1;
+    if (d < 0) d = -d;
+    h->stamp = loopTicks;
+    if (value < h->lo || value > h->hi)
+    {
+        if (h->rails < HEALTH_CONFIRM) h->rails++;
+    }
+    else
+        h->rails = 0;
+    if (h->stepMax && h->primed && d > h->stepMax)
+    {
+        d = value - h->cand;
+        if (d < 0) d = -d;
+        if (h->steps && d <= h->stepMax)
+            h->steps = 0;                   // Second sample at the new level: real change
+        else
+        {
+            h->cand = value;
+            if (h->steps < HEALTH_CONFIRM) h->steps++;
+            use = 0;
+        }
+    }
+    else
+        h->steps = 0;
+    if (use)
+    {
+        if (value == h->last && h->primed) { if (h->same < 255) h->same++; }
+        else h->same = 0;
+        h->last = value;
+        h->primed = 1;
+    }
+    if (h->rails >= HEALTH_CONFIRM) healthSet(h, HEALTH_RAIL);
+    else if (h->steps >= HEALTH_CONFIRM) healthSet(h, HEALTH_STEP);
+    else if (h->stuckMax && h->same >= h->stuckMax) healthSet(h, HEALTH_STUCK);
+    else healthSet(h, HEALTH_OK);
+    return use;
+}
+
+// healthTick(): Once per main-loop pass: ages every sensor (STALE after staleTicks).
+void healthTick(void)
+{
+    U8 i;
+    for (i = 0; i < SENSOR_COUNT; i++)
+        if (health[i].staleTicks && (U16)(loopTicks - health[i].stamp) > health[i].staleTicks)
+            healthSet(&health[i], HEALTH_STALE);
+}
+
+// ---------- [3] Fail-Safe Policy ----------
+// healthOk(): 1 if the sensor may take part in the decision.
+bit healthOk(U8 sensor)
+{
+    return health[sensor].status == HEALTH_OK;
+}
+
+// healthBlocks(): 1 if the sensor is faulty and its policy stops watering.
+bit healthBlocks(U8 sensor)
+{
+    return health[sensor].status != HEALTH_OK && health[sensor].failsafe == FAIL_BLOCK;
+}
+
+// ---------- [4] Status Icons ----------
+U8 healthShown[SENSOR_COUNT];           // Status drawn on the Project screen (0xFF = redraw)
+
+// healthIconsReset(): Forces a full redraw (the Project screen was just cleared).
+void healthIconsReset(void)
+{
+    U8 i;
+    for (i = 0; i < SENSOR_COUNT; i++) healthShown[i] = 0xFF;
+}
+
+// healthIcons(): Draws the changed icons of temp/soil/rain/light at (x, y).
+void healthIcons(int x, int y)
+{
+    U8 i, st;
+    char txt[3];
+    txt[2] = 0;
+    for (i = SENSOR_TEMP; i < SENSOR_COUNT; i++, x += 40)
+    {
+        st = health[i].status;
+        if (st == healthShown[i]) continue;
+        healthShown[i] = st;
+        txt[0] = healthLetter[i];
+        txt[1] = healthCode[st];
+        LCD_print2C(x, y, txt, 2, BLACK,
+                    st == HEALTH_OK ? GREEN : (health[i].failsafe == FAIL_BLOCK ? RED : YELLOW));
+    }
+}
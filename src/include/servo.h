@@ -0,0 +1,505 @@
+// ================== servo.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Sprinkler servo channels on PCA0 modules 0..3, addressed in degrees and moved by one
+// shared PCA-frame interrupt; the sweep dwells longer in the sectors that need water.
+// ----------------------------------------------------------
+// [1] Channels:
+//     -> SERVO_COUNT channels (site_config.h): channel n = PCA module n in 16-bit PWM
+//        mode on CEXn; module 4 is the watchdog (supervisor.h), so at most 4
+//     -> The crossbar gives CEX0..CEXn-1 the first free P0 pins (P0.2 = relay is
+//        skipped); the flow sensor input T0 follows them:
+//          SERVO_COUNT   CEX pins                  T0 (flow.h)
+//              1         P0.0                      P0.1
+//              2         P0.0 P0.1                 P0.3
+//              3         P0.0 P0.1 P0.3            P0.4
+//              4         P0.0 P0.1 P0.3 P0.4       P0.5
+// [2] PWM Frame:
+//     -> The PCA counter wraps every 65536 ticks = 16.384 ms: one servo frame
+//     -> PCA_ISR (counter overflow, CF) is the only writer of the compare registers,
+//        so every new width starts with a whole pulse (no glitch)
+// [3] Motion:
+//     -> Per channel: SERVO_HOLD (fixed angle) or SERVO_SWEEP (lo..hi and back, step
+//        degrees per frame), advanced inside PCA_ISR: a few s per channel per frame
+//        and no main-loop work; the main loop only changes modes and angles
+//     -> Angles are whole degrees 0..180, one byte: the main loop and the ISR share
+//        them without a torn read
+// [4] Parking:
+//     -> When a sweep stops the channel drives to its park angle, holds it for
+//        `settle` frames and then stops pulsing (ECOMn cleared at a frame edge:
+//        output LOW). A servo without pulses holds no torque and draws only its
+//        idle current; the Check screen "Servo" button shows which ones are driven
+//     -> Any new angle or sweep re-arms the output from PCA_ISR, so the first pulse
+//        after parking is a whole, frame-aligned one
+//     -> Channels boot in SERVO_PARK: to the park angle, then no pulses until
+//        irrigation starts
+// [5] Calibration:
+//     -> Per channel: the pulse widths at 0 and at 180 (reversed for a servo mounted
+//        the other way round). Defaults in site_config.h, per-unit values in DS1307
+//        NVRAM (NV_SERVO), set with servoCalibrate() from the Servo calibration
+//        screen (Check screen "Cal" button): the channel holds the end point being
+//        trimmed (servoSet) and parks again when the screen is left (servoRelease)
+//     -> Degree -> compare value is a 181-entry xdata table per channel, rebuilt only
+//        when its calibration changes: each frame is one table load and two SFR writes
+// [6] Sectors:
+//     -> The sweep range is split into SECTOR_COUNT sectors (site_config.h), each with
+//        a dwell weight 1..SECTOR_WEIGHT_MAX: a sweeping channel waits `weight`
+//        frames per step inside it, so a sector of weight 3 gets 3 times the water
+//     -> Weights are fixed, or follow the sector's own soil probe on a spare ADC
+//        input (drier -> heavier), sampled every SECTOR_PROBE_MS by sectorPoll()
+//     -> PCA_ISR reads a per-degree dwell table (servoDwell), rebuilt only when a
+//        weight changes: one byte load per step, no sector search in the ISR
+//     -> Water per sector (estimate): the flow pulses of each loop pass go to the
+//        sector channel 0 points into (all channels share the sector table)
+// PCA0MD (ECF) cannot be written while the watchdog runs: servoStart() comes before
+// superStart().
+
+// ---------- [1] Channels ----------
+#define SERVO_MAX       4       // PCA modules 0..3 (module 4 = watchdog)
+#define SERVO_DEG_MAX   180     // Angles 0..180
+#define SERVO_HOLD      0       // Fixed angle, output driven
+#define SERVO_SWEEP     1       // Sweeping lo..hi
+#define SERVO_PARK      2       // Moving to / settling at the park angle
+#define SERVO_IDLE      3       // Parked, output off
+#define SERVO_SETTLE    31      // Frames at the park angle before the output stops (~0.5 s)
+#define ECOM            0x40    // PCA0CPMn bit 6: comparator (PWM output) enable
+#define EPCA0           0x10    // EIE1 bit 4 -> PCA0 interrupt enable
+
+#if SERVO_COUNT == 1            // P0MDOUT bits of the CEX pins (push-pull)
+#define SERVO_PINS      0x01
+#elif SERVO_COUNT == 2
+#define SERVO_PINS      0x03
+#elif SERVO_COUNT == 3
+#define SERVO_PINS      0x0B
+#else
+#define SERVO_PINS      0x1B
+#endif
+
+typedef struct
+{
+    U8  deg;            // Angle (), loaded at the next frame
+    U8  lo, hi;         // Sweep limits (, 0..180)
+    U8  step;           // Sweep step per frame ()
+    U8  mode;           // SERVO_HOLD / SWEEP / PARK / IDLE
+    U8  up;             // Sweep direction: 1 = towards hi
+    U8  park;           // Park angle ()
+    U8  settle;         // Frames left at the park angle before the output stops
+    U8  hold;           // Frames left at the current sweep angle (sector dwell)
+} ServoChan;
+
+// 2 per 16.384 ms frame: 90 frames from 0 to 180 -> a full sweep (up and down)
+// takes ~2.9 s at dwell weight 1. Unused rows are ignored.
+//                          deg   lo   hi  step  mode        up  park  settle        hold
+ServoChan xdata servo[SERVO_MAX] = {
+    /* CEX0 */            {  90,   0, 180,   2, SERVO_PARK,  1,   90, SERVO_SETTLE, 0 },
+    /* CEX1 */            {  90,   0, 180,   2, SERVO_PARK,  1,   90, SERVO_SETTLE, 0 },
+    /* CEX2 */            {  90,   0, 180,   2, SERVO_PARK,  1,   90, SERVO_SETTLE, 0 },
+    /* CEX3 */            {  90,   0, 180,   2, SERVO_PARK,  1,   90, SERVO_SETTLE, 0 }
+};
+
+// ---------- [5] Calibration ----------
+#define SERVO_ABS_MIN_US    500     // Widest calibration range servoCalibrate() accepts
+#define SERVO_ABS_MAX_US    2500
+
+typedef struct
+{
+    U16 us0;            // Pulse width at 0 (s)
+    U16 us180;          // Pulse width at 180 (s)
+} ServoCal;
+
+ServoCal xdata servoCal[SERVO_MAX] = {
+    { SERVO_US_0, SERVO_US_180 }, { SERVO_US_0, SERVO_US_180 },
+    { SERVO_US_0, SERVO_US_180 }, { SERVO_US_0, SERVO_US_180 }
+};
+
+U16 xdata servoLut[SERVO_COUNT][SERVO_DEG_MAX + 1];    // Compare value per degree (see [2])
+#if LUT_SERVO && (LUT_GEN_SERVO_US_0 != SERVO_US_0 || LUT_GEN_SERVO_US_180 != SERVO_US_180)
+#error "lut_tables.h is out of date: run tools/gen_tables.py"
+#endif
+
+// ---------- [6] Sectors ----------
+#define SECTOR_MAX      4       // Rows of the sector table
+#define SECTOR_NO_PROBE 0xFF    // Sector without a soil probe: fixed weight
+#define SECTOR_PROBE_MS 30000UL // Probe sampling period
+
+typedef struct
+{
+    U8  from;           // First angle of the sector (); it ends where the next one starts
+    U8  weight;         // Dwell weight: frames per sweep step (1..SECTOR_WEIGHT_MAX)
+    U8  probe;          // ADC0 input of the sector's soil probe (AMX0P), or SECTOR_NO_PROBE
+    U32 pulses;         // Flow pulses delivered into the sector today
+} Sector;
+
+// Four equal sectors, even weights: the plain sweep. A probe on P2.3 for sector 0
+// would be { 0, 1, 0x03, 0 } (pin made analog by sectorStart()). Unused rows are ignored.
+//                          from  weight  probe            pulses
+Sector xdata sector[SECTOR_MAX] = {
+    /* S0 */              {    0,   1,    SECTOR_NO_PROBE,  0 },
+    /* S1 */              {   45,   1,    SECTOR_NO_PROBE,  0 },
+    /* S2 */              {   90,   1,    SECTOR_NO_PROBE,  0 },
+    /* S3 */              {  135,   1,    SECTOR_NO_PROBE,  0 }
+};
+
+U8 xdata servoDwell[SERVO_DEG_MAX + 1];     // Frames per sweep step at each angle (sector weight)
+
+// ---------- [2] PWM Frame ----------
+// PULSE WIDTH -> PCA COMPARE VALUE:
+// ----------------------------------------------------
+// - The PCA (Programmable Counter Array) operates at 4 MHz
+//   (derived from SYSCLK  12 = 48 MHz  12) -> each PCA tick = 0.25 s.
+// - In 16-bit PWM mode the output goes HIGH when the counter matches PCA0CPn and
+//   LOW when it wraps from 65535 to 0.
+// - To create a pulse of `w` microseconds (s), the match has to come 4  w ticks
+//   before the wrap: compare = 65536 - 4  w, i.e. the 2's complement of 4  w.
+//    600 s -> -2400   -> 2's Comp = 63136  -> HEX = 0xF6A0  -> 0   (default calibration)
+//   1500 s -> -6000   -> 2's Comp = 59536  -> HEX = 0xE890  -> 90
+//   2400 s -> -9600   -> 2's Comp = 55936  -> HEX = 0xDA80  -> 180
+// - servoLut holds these values per channel and degree (servoLutBuild()).
+// - The remainder of the 16.384 ms frame stays LOW.
+// - PCA0CPLn is written first (clears ECOMn), PCA0CPHn second (sets it again).
+#define SERVO_LOAD(n, c)    { PCA0CPL##n = (U8)(c); PCA0CPH##n = (U8)((c) >> 8); }
+
+// ---------- [3] Motion ----------
+// servoStep(): Advances channel n by a frame (PCA_ISR only).
+// Returns its compare value, or 0 = output off (0 is never a valid pulse).
+// NOAREGS: no absolute register addresses, so it runs in PCA_ISR's bank
+// (interrupt map in my_private_header.h).
+#ifndef SIM_HOST
+#pragma NOAREGS
+#endif
+U16 servoStep(U8 n)
+{
+    ServoChan xdata *s = &servo[n];
+    switch (s->mode)
+    {
+    case SERVO_SWEEP:
+        if (s->hold) { s->hold--; break; }  // Still dwelling at this angle
+        if (s->up)
+        {
+            if (s->deg + s->step >= s->hi) { s->deg = s->hi; s->up = 0; }   // Flip at the top end
+            else s->deg += s->step;
+        }
+        else
+        {
+            if (s->deg <= s->lo + s->step) { s->deg = s->lo; s->up = 1; }   // Flip at the bottom end
+            else s->deg -= s->step;
+        }
+        s->hold = servoDwell[s->deg] - 1;
+        break;
+    case SERVO_PARK:
+        s->deg = s->park;
+        if (s->settle) s->settle--;
+        else s->mode = SERVO_IDLE;          // Settled: stop pulsing from this frame on
+        break;
+    }
+    if (s->mode == SERVO_IDLE) return 0;
+    return servoLut[n][s->deg];
+}
+#ifndef SIM_HOST
+#pragma AREGS
+#endif
+
+// One channel per frame: a new compare value (re-arms ECOMn) or the output off.
+#define SERVO_FRAME(n)  { c = servoStep(n); \
+                          if (c) SERVO_LOAD(n, c) else PCA0CPM##n &= ~ECOM; }
+
+#ifndef SIM_HOST
+// PCA counter overflow: one servo frame. Cost grows with SERVO_COUNT only.
+void PCA_ISR(void) interrupt 11 using ISR_BANK_LO
+{
+    U16 c;
+    ISR_IN(ISR_PCA)
+    CF = 0;                             // Overflow flag is not cleared by hardware
+    SERVO_FRAME(0);
+#if SERVO_COUNT > 1
+    SERVO_FRAME(1);
+#endif
+#if SERVO_COUNT > 2
+    SERVO_FRAME(2);
+#endif
+#if SERVO_COUNT > 3
+    SERVO_FRAME(3);
+#endif
+    ISR_OUT(ISR_PCA);
+}
+#endif
+
+/*
+ * servoSet(): Holds a channel at an angle (from the next frame on).
+ * Parameters:
+ *   ch  - channel 0..SERVO_COUNT-1
+ *   deg - angle, clamped to 0..180; the pulse width comes from the channel's
+ *         calibration, so every unit reaches its own end points
+ */
+void servoSet(U8 ch, U8 deg)
+{
+    if (deg > SERVO_DEG_MAX) deg = SERVO_DEG_MAX;
+    EIE1 &= ~EPCA0;                     // Angle and mode change together
+    servo[ch].mode = SERVO_HOLD;
+    servo[ch].deg = deg;
+    EIE1 |= EPCA0;
+}
+
+// servoDeg(): Current angle of a channel ().
+U8 servoDeg(U8 ch)
+{
+    return servo[ch].deg;               // One byte: no masking needed
+}
+
+// servoOn(): 1 while the channel's output is pulsing (not parked).
+bit servoOn(U8 ch)
+{
+    return servo[ch].mode != SERVO_IDLE;
+}
+
+// servoRelease(): A channel held by servoSet() parks (output off after settling).
+void servoRelease(U8 ch)
+{
+    if (servo[ch].mode != SERVO_HOLD) return;
+    EIE1 &= ~EPCA0;                     // Settle count and mode change together
+    servo[ch].settle = SERVO_SETTLE;
+    servo[ch].mode = SERVO_PARK;
+    EIE1 |= EPCA0;
+}
+
+/*
+ * servoSweepAll(): Every channel sweeps (on = 1); on = 0 parks the sweeping ones.
+ * Called every loop: only a change of state does anything (a running park is not
+ * restarted, a channel held by servoSet() stays held until servoRelease()).
+ */
+void servoSweepAll(bit on)
+{
+    U8 i;
+    for (i = 0; i < SERVO_COUNT; i++)
+    {
+        if (on)
+        {
+            if (servo[i].mode != SERVO_HOLD)
+                servo[i].mode = SERVO_SWEEP;            // One byte: no masking needed
+        }
+        else if (servo[i].mode == SERVO_SWEEP)
+        {
+            EIE1 &= ~EPCA0;                             // Settle count and mode change together
+            servo[i].settle = SERVO_SETTLE;
+            servo[i].mode = SERVO_PARK;
+            EIE1 |= EPCA0;
+        }
+    }
+}
+
+// ---------- [5] Calibration ----------
+/*
+ * servoLutBuild(): Compare values of one channel for 0..180 from its calibration.
+ * The width steps by (us180 - us0)  4 / 180 ticks per degree; the remainder is
+ * carried (Bresenham) so no entry needs a division. The table is replaced with
+ * the PCA interrupt masked (~180 iterations): the next frame sees all of it.
+ */
+void servoLutBuild(U8 ch)
+{
+    U16 xdata *t = servoLut[ch];
+    U16 c = 0 - (servoCal[ch].us0 << 2);            // 0: -4  width ticks
+    S16 span = (S16)(servoCal[ch].us180 - servoCal[ch].us0) * 4;   // Ticks from 0 to 180
+    U16 mag = span < 0 ? -span : span;
+    U8  q = mag / SERVO_DEG_MAX;                    // Whole ticks per degree
+    U8  r = mag % SERVO_DEG_MAX;                    // Remainder, carried
+    U16 acc = 0;
+    U8  d, inc;
+    U8  ie = EIE1 & EPCA0;
+    EIE1 &= ~EPCA0;
+#if LUT_SERVO
+    if (servoCal[ch].us0 == SERVO_US_0 && servoCal[ch].us180 == SERVO_US_180)
+    {
+        for (d = 0; d <= SERVO_DEG_MAX; d++)
+            t[d] = servoLutDefault[d];              // Same values, generated at build time
+        EIE1 |= ie;
+        return;
+    }
+#endif
+    for (d = 0; d <= SERVO_DEG_MAX; d++)
+    {
+        t[d] = c;
+        inc = q;
+        acc += r;
+        if (acc >= SERVO_DEG_MAX) { acc -= SERVO_DEG_MAX; inc++; }
+        if (span > 0) c -= inc;                     // Wider pulse = earlier match
+        else c += inc;
+    }
+    EIE1 |= ie;
+}
+
+#define NV_SERVO_LEN    18      // Magic, 4  (0 LSB/MSB, 180 LSB/MSB), checksum
+#define NV_SERVO_MAGIC  0x6A
+
+U8 nvServoSum(U8 *b)
+{
+    U8 i, sum = 0;
+    for (i = 0; i < NV_SERVO_LEN - 1; i++) sum += b[i];
+    return (U8)~sum;
+}
+
+void servoCalSave(void)
+{
+    U8 b[NV_SERVO_LEN];
+    U8 i;
+    b[0] = NV_SERVO_MAGIC;
+    for (i = 0; i < SERVO_MAX; i++)
+    {
+        b[1 + i * 4] = (U8)servoCal[i].us0;
+        b[2 + i * 4] = (U8)(servoCal[i].us0 >> 8);
+        b[3 + i * 4] = (U8)servoCal[i].us180;
+        b[4 + i * 4] = (U8)(servoCal[i].us180 >> 8);
+    }
+    b[NV_SERVO_LEN - 1] = nvServoSum(b);
+    writeDS1307Burst(NV_SERVO, b, NV_SERVO_LEN);
+}
+
+// servoCalLoad(): Per-unit calibration from NVRAM (defaults stay on a blank/corrupt record).
+void servoCalLoad(void)
+{
+    U8 b[NV_SERVO_LEN];
+    U8 i;
+    U16 us0, us180;
+    if (readDS1307Burst(NV_SERVO, b, NV_SERVO_LEN) != I2C_OK) return;
+    if (b[0] != NV_SERVO_MAGIC || b[NV_SERVO_LEN - 1] != nvServoSum(b)) return;
+    for (i = 0; i < SERVO_MAX; i++)
+    {
+        us0   = ((U16)b[2 + i * 4] << 8) | b[1 + i * 4];
+        us180 = ((U16)b[4 + i * 4] << 8) | b[3 + i * 4];
+        if (us0 < SERVO_ABS_MIN_US || us0 > SERVO_ABS_MAX_US ||
+            us180 < SERVO_ABS_MIN_US || us180 > SERVO_ABS_MAX_US) continue;
+        servoCal[i].us0 = us0;
+        servoCal[i].us180 = us180;
+    }
+}
+
+/*
+ * servoCalibrate(): New end points for one unit, effective from the next frame
+ * and kept in NVRAM.
+ * Parameters:
+ *   ch    - channel 0..SERVO_COUNT-1
+ *   us0   - pulse width at 0   (s, clamped to 500..2500: wider values drive most
+ *   us180 - pulse width at 180  servos into their end stops)
+ */
+void servoCalibrate(U8 ch, U16 us0, U16 us180)
+{
+    if (us0 < SERVO_ABS_MIN_US) us0 = SERVO_ABS_MIN_US;
+    else if (us0 > SERVO_ABS_MAX_US) us0 = SERVO_ABS_MAX_US;
+    if (us180 < SERVO_ABS_MIN_US) us180 = SERVO_ABS_MIN_US;
+    else if (us180 > SERVO_ABS_MAX_US) us180 = SERVO_ABS_MAX_US;
+    servoCal[ch].us0 = us0;
+    servoCal[ch].us180 = us180;
+    servoLutBuild(ch);
+    servoCalSave();
+}
+
+// ---------- [6] Sectors ----------
+// sectorOf(): Sector an angle lies in.
+U8 sectorOf(U8 deg)
+{
+    U8 i = SECTOR_COUNT - 1;
+    while (i && deg < sector[i].from) i--;
+    return i;
+}
+
+// sectorBuild(): Dwell table from the sector weights. One byte per entry: the
+// ISR may see old and new entries for a frame, never a torn one.
+void sectorBuild(void)
+{
+    U8 d, i = 0;
+    for (d = 0; d <= SERVO_DEG_MAX; d++)
+    {
+        if (i + 1 < SECTOR_COUNT && d >= sector[i + 1].from) i++;
+        servoDwell[d] = sector[i].weight;
+    }
+}
+
+// sectorSetWeight(): New dwell weight for a sector (clamped to 1..SECTOR_WEIGHT_MAX).
+void sectorSetWeight(U8 i, U8 weight)
+{
+    if (weight < 1) weight = 1;
+    else if (weight > SECTOR_WEIGHT_MAX) weight = SECTOR_WEIGHT_MAX;
+    if (sector[i].weight == weight) return;     // Unchanged: no rebuild
+    sector[i].weight = weight;
+    sectorBuild();
+}
+
+// sectorStart(): Probe pins to analog inputs, first dwell table (servoStart()).
+void sectorStart(void)
+{
+    U8 i;
+    for (i = 0; i < SECTOR_COUNT; i++)
+    {
+        if (sector[i].probe == SECTOR_NO_PROBE) continue;
+        P2MDIN &= ~(1 << sector[i].probe);      // P2.n analog (High-Z), AMX0P n = P2.n
+        P2SKIP |= 1 << sector[i].probe;         // Not handed to the crossbar
+    }
+    sectorBuild();
+}
+
+U32 sectorProbeMs = 0;          // clockNow() of the last probe pass
+U16 sectorDay = 0;              // calYday the per-sector volumes belong to
+
+/*
+ * sectorPoll(): Once per main-loop pass. Every SECTOR_PROBE_MS the sectors with a
+ * probe get a weight from its dryness (same % scale as the soil sensor: 0% ->
+ * weight 1, 100% -> SECTOR_WEIGHT_MAX); a changed weight rebuilds the table.
+ */
+void sectorPoll(void)
+{
+    U8 i;
+    U16 pct;
+    if (elapsed(sectorProbeMs) < SECTOR_PROBE_MS) return;
+    sectorProbeMs = clockNow();
+    for (i = 0; i < SECTOR_COUNT; i++)
+    {
+        if (sector[i].probe == SECTOR_NO_PROBE) continue;
+        pct = ADC_PCT(ADC_IN_CHANNEL(sector[i].probe));
+        sectorSetWeight(i, 1 + (U8)(pct * (SECTOR_WEIGHT_MAX - 1) / 100));
+    }
+}
+
+/*
+ * sectorWater(): Books the flow pulses of one loop pass to the sector channel 0
+ * points into; the totals restart at midnight.
+ */
+void sectorWater(U16 pulses)
+{
+    U8 i;
+    if (calYday != sectorDay)
+    {
+        for (i = 0; i < SECTOR_MAX; i++) sector[i].pulses = 0;
+        sectorDay = calYday;
+    }
+    if (pulses) sector[sectorOf(servo[0].deg)].pulses += pulses;
+}
+
+// ---------- [1] Channels ----------
+/*
+ * servoStart(): Loads the calibration, builds the degree tables, enables channels
+ * 1..SERVO_COUNT-1 next to module 0 (Init_Device), routes them through the
+ * crossbar and starts the frame interrupt.
+ * Call before superStart() (PCA0MD is locked while the watchdog runs).
+ */
+void servoStart(void)
+{
+    U8 i;
+    servoCalLoad();
+    for (i = 0; i < SERVO_COUNT; i++)
+        servoLutBuild(i);
+    sectorStart();
+#if SERVO_COUNT > 1
+    PCA0CPM1 = 0xC2;                    // PWM16 + ECOM + PWM, as module 0
+#endif
+#if SERVO_COUNT > 2
+    PCA0CPM2 = 0xC2;
+#endif
+#if SERVO_COUNT > 3
+    PCA0CPM3 = 0xC2;
+#endif
+    XBR1 = (XBR1 & ~0x07) | SERVO_COUNT;    // PCA0ME: CEX0..CEX(SERVO_COUNT-1) on the crossbar
+    P0MDOUT |= SERVO_PINS;              // CEX pins push-pull (clean PWM edges)
+    PCA0MD |= 0x01;                     // ECF = 1: counter overflow raises CF
+    EIE1 |= EPCA0;                      // PCA0 interrupt on
+    CF = 1;                             // Load every channel right away (PCA_ISR runs at once)
+}
@@ -0,0 +1,309 @@
+// ================== shadow_clock.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Timer2 shadow clock, DS1307 drift measurement and digital trim.
+// ----------------------------------------------------------
+// [1] Timebase:
+//     -> Timer2 overflows every 1 ms (SYSCLK / 12, 16-bit auto-reload, see Init_Device)
+//     -> The ISR advances clockMs (the monotonic clock, timebase.h) and the time of
+//        day (shadowSec) through a nanosecond accumulator: every tick adds
+//        1 ms + trim (1 ppm of 1 ms = 1 ns)
+//     -> The main loop takes hour/minute/second from here (no IC per loop)
+// [2] Drift Measurement:
+//     -> The DS1307 seconds edge is caught by reading 0x00..0x02 once per loop
+//        until the seconds change (edge hunt); clockMs at that read is the edge time
+//     -> RTC seconds vs Timer2 milliseconds between two edges DRIFT_WINDOW_S apart
+//        give the rate of one clock against the other in ppm
+// [3] Trim and Persistence:
+//     -> Each window's result is smoothed into shadowTrimPpm (1/2^DRIFT_EMA_SHIFT),
+//        which sets the shadow clock step; the record lives in DS1307 NVRAM (NV_TRIM)
+//        and is applied at boot, before the first window completes
+// [4] Write-back:
+//     -> After each window the shadow time is compared with the RTC at the edge;
+//        an offset of DRIFT_WRITEBACK_S or more is written back to the DS1307
+// [5] Diagnostics:
+//     -> Trim, last window result, offset and write-backs (Diag screen)
+//
+// Which clock is wrong:
+//   Comparing two oscillators only gives their ratio. The 48 MHz SYSCLK comes from
+//   the internal oscillator (0.25 %), the DS1307 from a 32.768 kHz crystal (tens of
+//   ppm), so the measured ratio is applied to the shadow clock: it runs at the RTC
+//   rate between edges, without reading the RTC. RTC_XTAL_PPM is the crystal's own
+//   error (measure SQW/OUT at 1 Hz once with a frequency counter); it is taken out of
+//   the shadow clock, and the periodic write-back removes it from the DS1307.
+// Resolution:
+//   An edge is located to within one main-loop pass (~20..40 ms) at both ends of a
+//   window: ~2 ppm per 6 h window before smoothing.
+
+// ---------- [1] Timebase ----------
+#define SHADOW_TICK_NS  1000000UL   // Nominal Timer2 period: 1 ms
+#define SHADOW_SEC_NS   1000000000UL
+#define SHADOW_DAY_S    86400UL
+#define RTC_XTAL_PPM    0           // Known DS1307 crystal error (ppm, + = RTC fast); 0 = not calibrated
+
+volatile U32 shadowSec = 0;         // Time of day in seconds (0..86399)
+volatile U32 shadowNs = 0;          // Fraction of the current second (ns)
+volatile U32 shadowStep = SHADOW_TICK_NS;   // ns added per tick = 1 ms + trim
+S16 shadowTrimPpm = 0;              // Timer2 -> RTC rate correction (smoothed)
+volatile U16 wdtCredit = 0;         // ms the ISR may still feed the watchdog (renewed by supervisor.h)
+
+#ifndef SIM_HOST
+// Timer2 overflow: 1 ms tick. Kept short: one 32-bit add and compare per tick.
+// It also feeds the PCA watchdog while the supervisor grants credit; without
+// credit the pump is forced off every tick until the watchdog resets the MCU.
+void Timer2_ISR(void) interrupt 5 using ISR_BANK_HI
+{
+    ISR_IN(ISR_T2)
+    TF2H = 0;                       // Timer2 high-byte overflow flag is not cleared by hardware
+    clockMs++;
+    if (wdtCredit)
+    {
+        wdtCredit--;
+        PCA0CPH4 = 0x00;            // Any write to PCA0CPH4 restarts the watchdog
+    }
+    else
+        Relay = 0;                  // Loop stalled or a task missed its deadline
+    shadowNs += shadowStep;
+    if (shadowNs >= SHADOW_SEC_NS)
+    {
+        shadowNs -= SHADOW_SEC_NS;
+        if (++shadowSec >= SHADOW_DAY_S) shadowSec = 0;
+    }
+    ISR_OUT(ISR_T2);
+}
+#endif
+
+// shadowNow(): Time of day in seconds (interrupt-safe copy).
+U32 shadowNow(void)
+{
+    U32 s;
+    ET2 = 0;
+    s = shadowSec;
+    ET2 = 1;
+    return s;
+}
+
+// shadowRounded(): Time of day rounded to the nearest second (for writing to the RTC).
+U32 shadowRounded(void)
+{
+    U32 s, ns;
+    ET2 = 0;
+    s = shadowSec;
+    ns = shadowNs;
+    ET2 = 1;
+    if (ns >= SHADOW_SEC_NS / 2 && ++s >= SHADOW_DAY_S) s = 0;
+    return s;
+}
+
+// shadowHms(): Splits the shadow time of day into hours, minutes and seconds.
+void shadowHms(int *h, int *m, int *s)
+{
+    U32 t = shadowNow();
+    *h = t / 3600;
+    *m = (t / 60) % 60;
+    *s = t % 60;
+}
+
+// shadowApplyTrim(): Loads the tick step for the current trim (and crystal correction).
+void shadowApplyTrim(void)
+{
+    ET2 = 0;
+    shadowStep = SHADOW_TICK_NS + shadowTrimPpm - RTC_XTAL_PPM;
+    ET2 = 1;
+}
+
+// ---------- [2] Drift Measurement ----------
+#define DRIFT_WINDOW_S      21600UL // Measurement window: 6 h of Timer2 time between two edges
+#define DRIFT_MAX_PPM       20000   // Larger results are discarded (clock set, halted or glitch)
+#define DRIFT_EMA_SHIFT     2       // Smoothing: trim += (result - trim) / 4
+#define DRIFT_WRITEBACK_S   1       // Write the shadow time back once the RTC is this far off
+#define DRIFT_HUNT_LOOPS    100     // Give up an edge hunt after this many reads (RTC halted)
+
+bit driftHunting = 1;               // 1 = reading the RTC every loop until its seconds change
+bit driftAnchored = 0;              // 1 = anchor holds a valid edge (window in progress)
+U8  driftHuntReads = 0;             // Reads in the current hunt
+U8  driftLastSec = 0xFF;            // Seconds register (BCD) of the previous hunt read
+U32 driftAnchorMs = 0;              // clockMs at the anchor edge
+U32 driftAnchorSec = 0;             // RTC time of day at the anchor edge
+S16 driftLastPpm = 0;               // Result of the last completed window
+U32 driftLastWindow = 0;            // Length of that window (s)
+S16 driftOffset = 0;                // Shadow - RTC at the last edge (s)
+U8  driftWindows = 0;               // Windows folded into the trim (saturates at 255)
+U16 driftWritebacks = 0;            // Times the shadow time was written back to the DS1307
+
+// rtcDaySec(): BCD seconds/minutes/hours registers -> seconds of the day.
+U32 rtcDaySec(U8 *r)
+{
+    return (U32)bcdToDec(r[2] & 0x3F) * 3600 + bcdToDec(r[1] & 0x7F) * 60 + bcdToDec(r[0] & 0x7F);
+}
+
+// ---------- [3] Trim and Persistence ----------
+// NV_TRIM record (5 bytes): magic, trim LSB, trim MSB, windows, checksum
+#define NV_TRIM_MAGIC   0x5D
+#define NV_TRIM_LEN     5
+
+U8 nvTrimSum(U8 *b)
+{
+    return (U8)~(b[0] + b[1] + b[2] + b[3]);
+}
+
+void driftSave(void)
+{
+    U8 b[NV_TRIM_LEN];
+    b[0] = NV_TRIM_MAGIC;
+    b[1] = (U8)shadowTrimPpm;
+    b[2] = (U8)((U16)shadowTrimPpm >> 8);
+    b[3] = driftWindows;
+    b[4] = nvTrimSum(b);
+    writeDS1307Burst(NV_TRIM, b, NV_TRIM_LEN);
+}
+
+// driftLoad(): Restores the trim measured before the last reset (blank/corrupt NVRAM -> 0 ppm).
+void driftLoad(void)
+{
+    U8 b[NV_TRIM_LEN];
+    if (readDS1307Burst(NV_TRIM, b, NV_TRIM_LEN) != I2C_OK) return;
+    if (b[0] != NV_TRIM_MAGIC || b[4] != nvTrimSum(b)) return;
+    shadowTrimPpm = (S16)(((U16)b[2] << 8) | b[1]);
+    driftWindows = b[3];
+    shadowApplyTrim();
+}
+
+/*
+ * driftFold(): Turns one window into a ppm result and folds it into the trim.
+ *   ppm = (RTC ms - Timer2 ms)  10^6 / Timer2 ms, computed as
+ *   diff  1000 / (Timer2 s) so the product stays inside 32 bits
+ *   (|diff| is limited to DRIFT_MAX_PPM of the window first).
+ */
+void driftFold(U32 rtcSec, U32 mcuMs)
+{
+    S32 diff = (S32)(rtcSec * 1000UL) - (S32)mcuMs;
+    S32 limit = (S32)(mcuMs / (1000000UL / DRIFT_MAX_PPM));
+    S32 ppm;
+    if (mcuMs < 1000UL || diff > limit || diff < -limit) return;
+    ppm = diff * 1000L / (S32)(mcuMs / 1000UL);
+    driftLastPpm = (S16)ppm;
+    driftLastWindow = mcuMs / 1000UL;
+    if (driftWindows == 0)
+        shadowTrimPpm = (S16)ppm;               // First result: take it as is
+    else
+        shadowTrimPpm += (S16)((ppm - shadowTrimPpm) / (1 << DRIFT_EMA_SHIFT));
+    if (driftWindows != 255) driftWindows++;
+    shadowApplyTrim();
+    driftSave();
+}
+
+// ---------- [4] Edge Handling and Write-back ----------
+/*
+ * driftEdge(): Called with the RTC time and clockMs of a freshly caught seconds edge.
+ *   - No anchor yet (boot, after a clock set): align the shadow clock to the edge.
+ *   - Window complete: fold the result, then write the shadow time back if the RTC
+ *     has moved DRIFT_WRITEBACK_S or more away from it.
+ *   - The edge (or the write-back, which restarts the DS1307 divider) is the next anchor.
+ */
+void driftEdge(U32 rtcSec, U32 t)
+{
+    U32 shadow, elapsed;
+    S32 off;
+    if (!driftAnchored)
+    {
+        ET2 = 0;
+        shadowSec = rtcSec;                     // Shadow second starts with the RTC second
+        shadowNs = 0;
+        ET2 = 1;
+    }
+    else
+    {
+        elapsed = (rtcSec + SHADOW_DAY_S - driftAnchorSec) % SHADOW_DAY_S;
+        driftFold(elapsed, t - driftAnchorMs);
+        shadow = shadowRounded();               // RTC is at rtcSec + 0 s right now
+        off = (S32)shadow - (S32)rtcSec;
+        if (off >  (S32)(SHADOW_DAY_S / 2)) off -= SHADOW_DAY_S;   // Midnight between the two
+        if (off < -(S32)(SHADOW_DAY_S / 2)) off += SHADOW_DAY_S;
+        driftOffset = (S16)off;
+        // Not across midnight: hours/minutes/seconds alone must not change the date
+        if ((off >= DRIFT_WRITEBACK_S || off <= -DRIFT_WRITEBACK_S) &&
+            shadow > 10 && shadow < SHADOW_DAY_S - 10)
+        {
+            shadow = shadowRounded();
+            t = clockNow();
+            if (setupTime(shadow / 3600, (shadow / 60) % 60, shadow % 60) == I2C_OK)
+            {
+                rtcSec = shadow;                // DS1307 second restarts at the write
+                driftWritebacks++;
+            }
+        }
+    }
+    driftAnchorMs = t;
+    driftAnchorSec = rtcSec;
+    driftAnchored = 1;
+}
+
+/*
+ * driftPoll(): Once per main-loop pass.
+ *   - Outside a hunt: only checks whether the window is complete (no IC).
+ *   - During a hunt: one 3-byte burst read of the RTC; a change of the seconds
+ *     register is the edge. A halted RTC (CH = 1) or a hunt that never sees an
+ *     edge drops the anchor, so a bad window is never folded into the trim.
+ */
+void driftPoll(void)
+{
+    U8 r[3];
+    U32 t = clockNow();
+    if (!driftHunting)
+    {
+        if (t - driftAnchorMs >= DRIFT_WINDOW_S * 1000UL)
+        {
+            driftHunting = 1;
+            driftHuntReads = 0;
+            driftLastSec = 0xFF;
+        }
+        return;
+    }
+    if (readDS1307Burst(0x00, r, 3) != I2C_OK) return;     // Try again next pass
+    if ((r[0] & 0x80) || ++driftHuntReads > DRIFT_HUNT_LOOPS)
+    {
+        driftAnchored = 0;                                  // Oscillator halted: no edge to measure
+        driftHunting = 0;
+        driftAnchorMs = t;                                  // Retry after another window
+        return;
+    }
+    if (driftLastSec != 0xFF && r[0] != driftLastSec)
+    {
+        driftEdge(rtcDaySec(r), t);
+        driftHunting = 0;
+    }
+    driftLastSec = r[0];
+}
+
+/*
+ * shadowSet(): The DS1307 was just written with this time (Setup screen).
+ *   The write restarted the RTC divider, so it is an edge: the shadow clock and the
+ *   anchor restart here; a window spanning the change is never measured.
+ */
+void shadowSet(U32 daySec)
+{
+    ET2 = 0;
+    shadowSec = daySec;
+    shadowNs = 0;
+    ET2 = 1;
+    driftAnchorMs = clockNow();
+    driftAnchorSec = daySec;
+    driftAnchored = 1;
+    driftHunting = 0;
+}
+
+// shadowInit(): Boot: load the stored trim and start the shadow clock from the RTC
+// registers 0x00..0x02 in r (read by the caller; 0 = RTC not readable, start at 00:00:00).
+// The first edge hunt (driftHunting = 1) then aligns it to the RTC second.
+void shadowInit(U8 *r)
+{
+    driftLoad();
+    if (r)
+    {
+        ET2 = 0;
+        shadowSec = rtcDaySec(r);
+        ET2 = 1;
+    }
+}
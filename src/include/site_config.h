@@ -0,0 +1,78 @@
+// ================== site_config.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Installation site and watering-window configuration.
+// ----------------------------------------------------------
+// [1] Location:
+//     -> Latitude/longitude in 1/100 degree (north/east positive), used by the
+//        once-per-day sunrise/sunset solver (solar.h)
+//     -> Time zone of the RTC time in minutes east of UTC
+// [2] Watering Windows:
+//     -> Each window edge is a fixed clock time or an offset (minutes) from
+//        today's sunrise or sunset; the edges are resolved once per day (calendar.h)
+// [3] Rain Delay:
+//     -> How much integrated rain skips how many of the following windows (rain.h)
+// [4] Flow Meter:
+//     -> Pulses per litre of the hall-effect sensor and the volume that closes a
+//        window early (flow.h)
+// [5] Sprinkler Servos:
+//     -> Number of servo channels and their default end points (servo.h)
+//     -> Number of sweep sectors and the heaviest dwell weight (servo.h [6])
+
+// ---------- [1] Location ----------
+#define SITE_LAT_CDEG   3208    // 32.08 N  (Tel Aviv)
+#define SITE_LON_CDEG   3478    // 34.78 E
+#define SITE_TZ_MIN     120     // UTC+2: the RTC is kept on local standard time (no DST switch)
+                                // -> a clock set to summer time shifts solar windows by 1 h
+
+// ---------- [2] Watering Windows ----------
+// Edge references (WaterWindow.openRef / closeRef)
+#define WIN_CLOCK       0       // Minutes of the day (0..1440)
+#define WIN_SUNRISE     1       // Minutes relative to today's sunrise
+#define WIN_SUNSET      2       // Minutes relative to today's sunset
+
+// Window 0 (morning): 04:00 - 08:00
+#define WIN0_OPEN_REF   WIN_CLOCK
+#define WIN0_OPEN       240
+#define WIN0_CLOSE_REF  WIN_CLOCK
+#define WIN0_CLOSE      480
+// Window 1 (evening): 19:00 - 22:00
+#define WIN1_OPEN_REF   WIN_CLOCK
+#define WIN1_OPEN       1140
+#define WIN1_CLOSE_REF  WIN_CLOCK
+#define WIN1_CLOSE      1320
+// Solar windows follow the day length through the year, e.g. from 60 min before
+// sunrise to 2 h after it, and from 30 min after sunset to 3 h after it:
+//   #define WIN0_OPEN_REF   WIN_SUNRISE     #define WIN1_OPEN_REF   WIN_SUNSET
+//   #define WIN0_OPEN       (-60)           #define WIN1_OPEN       30
+//   #define WIN0_CLOSE_REF  WIN_SUNRISE     #define WIN1_CLOSE_REF  WIN_SUNSET
+//   #define WIN0_CLOSE      120             #define WIN1_CLOSE      180
+
+// ---------- [3] Rain Delay ----------
+// The rain index counts wet-minutes: one minute of the sensor at full wetness
+// (shorter at higher wetness, longer at lower). A finished rain event skips
+// index / RAIN_WET_MIN_PER_WINDOW windows, at most RAIN_DELAY_MAX.
+#define RAIN_WET_MIN_PER_WINDOW 20  // Wet-minutes per skipped window
+#define RAIN_DELAY_MAX          6   // Longest rain delay (windows), 0 = rain delay off
+
+// ---------- [4] Flow Meter ----------
+// Hall-effect flow sensor on the T0 input (P0.1 with one servo, see servo.h). The
+// K-factor is on the sensor's data sheet (YF-S201: f = 7.5 Hz per L/min -> 450
+// pulses per litre); measure a bucket to calibrate it.
+#define FLOW_PULSES_PER_L       450     // Sensor pulses per litre
+#define FLOW_TARGET_ML          20000   // Water per window: the pump stops once it has flowed (0 = no limit)
+
+// ---------- [5] Sprinkler Servos ----------
+// One servo per PCA module 0..SERVO_COUNT-1; all of them sweep while the pump runs.
+// More channels move the flow-sensor input (pin table in servo.h).
+#define SERVO_COUNT             1       // Servo channels, 1..4
+// Pulse widths at 0 and 180 for a unit without its own calibration in NVRAM
+// (servoCalibrate() stores per-unit values; swap them for a reversed mounting).
+#define SERVO_US_0              600     // s at 0
+#define SERVO_US_180            2400    // s at 180
+// The sweep range is split into sectors (edges, weights and probes in the servo.h
+// sector table); a sector of weight w is swept w times slower and gets w times the
+// water.
+#define SECTOR_COUNT            4       // Sweep sectors, 1..4
+#define SECTOR_WEIGHT_MAX       4       // Dwell weight of a fully dry probed sector
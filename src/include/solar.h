@@ -0,0 +1,145 @@
+// ================== solar.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Fixed-point sunrise/sunset solver, run once per day for the watering windows.
+// ----------------------------------------------------------
+// [1] Fixed-Point Trigonometry:
+//     -> Angles are 16-bit binary angles (65536 = 360): 2g, 3g and negative
+//        angles wrap for free in U16 arithmetic
+//     -> sinBa()/cosBa(): 65-entry quarter-wave Q15 table + linear interpolation
+//     -> asinBa(): bisection on sinBa() (16 steps)
+// [2] Solar Position (NOAA series, evaluated at local noon):
+//     -> Fractional year g, equation of time (s), declination (binary angle)
+//     -> Series coefficients are pre-scaled to the output unit in Q3
+// [3] Sunrise/Sunset:
+//     -> cos H = (sin h0 - sin lat sin decl) / (cos lat cos decl),
+//        h0 = -0.833 (refraction + solar disc)
+//     -> Times in minutes of the local day (longitude and time zone from site_config.h)
+//     -> Polar night / midnight sun: solarRise = solarSet = SOLAR_NONE
+// Cost: about 30 sinBa() calls and one 32-bit division per day; nothing runs in
+// the main loop. Accuracy against the same series in double precision is checked
+// by the host simulation (sim/solar_ref.c).
+// Every product fits the 32-bit C51 long. Solver constants are (S32), not L-suffixed:
+// on a 64-bit host `L` would widen the product and hide an overflow from the check.
+
+// ---------- [1] Fixed-Point Trigonometry ----------
+#define BA_90           16384   // 90 as a binary angle
+#define BA_FROM_CDEG(c) ((S16)((S32)(c) * 65536L / 36000L))    // 1/100 degree -> binary angle
+
+// sin(i  90 / 64) in Q15, i = 0..64
+S16 code sinQuarter[65] = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,  6393,
+     7179,  7962,  8739,  9512, 10278, 11039, 11793, 12539, 13279,
+    14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868, 19519,
+    20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811,
+    25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898,
+    29268, 29621, 29956, 30273, 30571, 30852, 31113, 31356, 31580,
+    31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728,
+    32757, 32767
+};
+
+// sinBa(): sin of a binary angle, Q15.
+S16 sinBa(U16 a)
+{
+    U8  quadrant = a >> 14;
+    U16 x = a & 0x3FFF;                     // Position inside the quadrant
+    U8  i;
+    S16 s;
+    if (quadrant & 1) x = BA_90 - x;        // Quadrants 1 and 3 run the table backwards
+    i = x >> 8;                             // 64 table steps of 256 units
+    if (i >= 64)
+        s = sinQuarter[64];
+    else
+        s = sinQuarter[i] + (S16)(((S32)(sinQuarter[i + 1] - sinQuarter[i]) * (x & 0xFF)) >> 8);
+    return (quadrant & 2) ? -s : s;         // Quadrants 2 and 3 are negative
+}
+
+// cosBa(): cos of a binary angle, Q15.
+S16 cosBa(U16 a)
+{
+    return sinBa(a + BA_90);
+}
+
+// asinBa(): asin of a Q15 value, binary angle in -90..+90.
+S16 asinBa(S16 v)
+{
+    S16 lo = -BA_90, hi = BA_90, mid;
+    while (hi - lo > 1)
+    {
+        mid = (S16)((lo + hi) / 2);
+        if (sinBa((U16)mid) < v) lo = mid;
+        else hi = mid;
+    }
+    return hi;
+}
+
+// ---------- [2] + [3] Solar Position, Sunrise/Sunset ----------
+#define SOLAR_NONE      (-1)    // No sunrise/sunset today (polar night or midnight sun)
+#define SIN_H0_Q15      (-476)  // sin(-0.833) in Q15
+
+S16 solarRise = SOLAR_NONE;     // Today's sunrise, minutes of the local day
+S16 solarSet  = SOLAR_NONE;     // Today's sunset
+S16 solarNoon = 720;            // Solar noon (always defined)
+
+// solarMinutes(): Local seconds (any range) -> minutes of the day, rounded, 0..1439.
+S16 solarMinutes(S32 s)
+{
+    s = (s + 30) / 60;
+    while (s < 0) s += 1440;
+    while (s >= 1440) s -= 1440;
+    return (S16)s;
+}
+
+/*
+ * solarCalc(): Sunrise, sunset and solar noon for one day and site.
+ * Parameters:
+ *   yday    - day of the year, 1..366
+ *   latCdeg - latitude in 1/100 degree (north positive, |lat| < 89)
+ *   lonCdeg - longitude in 1/100 degree (east positive)
+ *   tzMin   - time zone of the result in minutes east of UTC
+ * Results in solarRise / solarSet / solarNoon.
+ */
+void solarCalc(U16 yday, S16 latCdeg, S16 lonCdeg, S16 tzMin)
+{
+    U16 g = (U16)(((U32)(yday - 1) << 16) / 365);  // Fractional year g at noon
+    S16 cg = cosBa(g), sg = sinBa(g);
+    S16 c2 = cosBa(g << 1), s2 = sinBa(g << 1);
+    S16 c3 = cosBa(g * 3), s3 = sinBa(g * 3);
+    S16 lat = BA_FROM_CDEG(latCdeg);
+    S16 eot, decl, sinD, cosD, sinL, cosL;
+    S32 num, den, noon, h;
+
+    // Equation of time (s) = 13750.8  (0.000075 + 0.001868 cos g - 0.032077 sin g
+    //                                   - 0.014615 cos2g - 0.040849 sin2g)
+    eot = 1 + (S16)(((S32)205 * cg - (S32)3529 * sg - (S32)1608 * c2 - (S32)4494 * s2) >> 18);
+    // Declination (binary angle) = 10430.4  (0.006918 - 0.399912 cos g + 0.070257 sin g
+    //              - 0.006758 cos2g + 0.000907 sin2g - 0.002697 cos3g + 0.00148 sin3g)
+    decl = (S16)(((S32)577 * 32768 - (S32)33370 * cg + (S32)5862 * sg - (S32)564 * c2
+                 + (S32)76 * s2 - (S32)225 * c3 + (S32)123 * s3) >> 18);
+
+    noon = (S32)43200 - (S32)lonCdeg * 12 / 5 - eot + (S32)tzMin * 60;   // 4 min per degree of longitude
+    solarNoon = solarMinutes(noon);
+
+    sinD = sinBa((U16)decl);
+    cosD = cosBa((U16)decl);
+    sinL = sinBa((U16)lat);
+    cosL = cosBa((U16)lat);
+    num = SIN_H0_Q15 - (((S32)sinL * sinD) >> 15);
+    den = ((S32)cosL * cosD) >> 15;
+    if (num >= den || num <= -den)          // |cos H| >= 1: the sun never crosses h0 today
+    {
+        solarRise = solarSet = SOLAR_NONE;
+        return;
+    }
+    h = BA_90 - asinBa((S16)(num * 32768 / den));    // H = acos(cos H), binary angle 0..180
+    h = (h * 675) >> 9;                              // Hour angle -> seconds:  86400 / 65536 (360 = 24 h)
+    solarRise = solarMinutes(noon - h);
+    solarSet  = solarMinutes(noon + h);
+}
+
+// solarDay(): Today's sun times at the configured site (site_config.h).
+void solarDay(U16 yday)
+{
+    solarCalc(yday, SITE_LAT_CDEG, SITE_LON_CDEG, SITE_TZ_MIN);
+}
@@ -0,0 +1,147 @@
+// ================== supervisor.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Deadline supervisor for the periodic activities and the PCA watchdog behind it.
+// ----------------------------------------------------------
+// [1] Tasks and Deadlines:
+//     -> superRegister(): each periodic activity registers its deadline (ms)
+//     -> superCheckIn(): the activity ran (stamp = clockNow()); it checks in when it
+//        ran, not when it succeeded: sensor faults belong to sensor_health.h
+// [2] Miss Detection (superPoll(), once per loop):
+//     -> A task older than its deadline is a miss: counted once per overrun with
+//        its clockMs timestamp and the worst lateness; the pump goes off at once
+// [3] Watchdog:
+//     -> PCA module 4 in watchdog mode. With the PCA on SYSCLK / 12 (servo PWM) the
+//        longest timeout is 256  255 + 256 ticks ~ 16.4 ms, shorter than one loop
+//        pass, so the 1 ms Timer2 ISR feeds it while wdtCredit lasts
+//     -> superPoll() renews wdtCredit only when every task is inside its deadline:
+//        a stalled loop (stuck bus, blocked LCD write) or a missed task stops the
+//        feeding, the ISR switches the relay off and the watchdog resets the MCU
+//        SUPER_FEED_MS + ~16 ms later; interrupts disabled for 16 ms reset it too
+//     -> Init_Device() switches the relay off before anything else, so the pump
+//        stays off through every reset path until runProject decides again
+// [4] Reset Cause and Statistics:
+//     -> RSTSRC is checked at boot; watchdog resets and the task that missed last
+//        are kept in DS1307 NVRAM (NV_SUPER) and shown on the Diag screen
+
+// ---------- [1] Tasks and Deadlines ----------
+#define TASK_LOOP       0       // Main-loop pass (deadline < SUPER_FEED_MS: slow passes are counted)
+#define TASK_TEMP       1       // LM75 batch pass (sampling policy: at most every 250 loops)
+#define TASK_ADC        2       // Light/rain ADC samples (at most every 100 loops)
+#define TASK_COUNT      3
+
+#define SUPER_FEED_MS   1000    // Watchdog feeding granted per healthy superPoll() (> longest LCD redraw)
+#define SUPER_NONE      0xFF    // No task missed yet
+
+typedef struct
+{
+    U16 deadlineMs;             // 0 = not supervised
+    U32 stamp;                  // clockNow() of the last check-in
+    U16 misses;                 // Overruns since reset
+    U32 lastMissMs;             // clockNow() when the last overrun was detected
+    U16 worstMs;                // Longest time past the deadline (ms, saturating)
+    U8  late;                   // 1 while the current overrun is being counted
+} TaskDeadline;
+
+TaskDeadline xdata task[TASK_COUNT];
+char code taskLetter[TASK_COUNT] = { 'L', 'T', 'A' };
+
+U8  superLastMiss = SUPER_NONE; // Task of the most recent miss (kept across a watchdog reset)
+U8  superWdtResets = 0;         // Watchdog resets seen at boot (NVRAM, saturating)
+bit superWdtReset = 0;          // 1 = this boot followed a watchdog reset
+
+// superRegister(): Puts a task under supervision (its deadline starts now).
+void superRegister(U8 id, U16 deadlineMs)
+{
+    task[id].deadlineMs = deadlineMs;
+    task[id].stamp = clockNow();
+    task[id].late = 0;
+}
+
+// superCheckIn(): The task ran.
+void superCheckIn(U8 id)
+{
+    task[id].stamp = clockNow();
+    task[id].late = 0;
+}
+
+// ---------- [4] Reset Cause and Statistics ----------
+#define NV_SUPER_LEN    4       // Magic, watchdog resets, last missed task, checksum
+#define NV_SUPER_MAGIC  0x3C
+
+void superSave(void)
+{
+    U8 b[NV_SUPER_LEN];
+    b[0] = NV_SUPER_MAGIC;
+    b[1] = superWdtResets;
+    b[2] = superLastMiss;
+    b[3] = (U8)~(b[0] + b[1] + b[2]);
+    writeDS1307Burst(NV_SUPER, b, NV_SUPER_LEN);
+}
+
+// ---------- [2] Miss Detection ----------
+/*
+ * superPoll(): Once per main-loop pass, at its end (checks in TASK_LOOP itself).
+ *   - A task past its deadline: one miss per overrun, pump off, record saved.
+ *     A slow loop pass that still returned counts as a TASK_LOOP miss; a loop that
+ *     never returns is caught by the watchdog alone.
+ *   - All tasks inside their deadlines: SUPER_FEED_MS more watchdog feeding.
+ */
+void superPoll(void)
+{
+    U8 i;
+    bit ok = 1;
+    U32 now = clockNow(), age;
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        if (!task[i].deadlineMs) continue;
+        age = now - task[i].stamp;
+        if (age <= task[i].deadlineMs) continue;
+        ok = 0;
+        age -= task[i].deadlineMs;
+        if (age > task[i].worstMs) task[i].worstMs = age > 0xFFFF ? 0xFFFF : (U16)age;
+        if (task[i].late) continue;
+        task[i].late = 1;                       // Count this overrun once
+        task[i].misses++;
+        task[i].lastMissMs = now;
+        superLastMiss = i;
+        Relay_Off();                            // Never water on a misbehaving loop
+        superSave();
+    }
+    superCheckIn(TASK_LOOP);
+    if (ok)
+    {
+        ET2 = 0;                                // 16-bit credit is shared with the ISR
+        wdtCredit = SUPER_FEED_MS;
+        ET2 = 1;
+    }
+}
+
+// ---------- [3] Watchdog ----------
+/*
+ * superStart(): Reads the reset cause, restores the statistics and enables the
+ * watchdog (call at the end of the boot sequence, right before the main loop).
+ */
+void superStart(void)
+{
+    U8 b[NV_SUPER_LEN];
+    superWdtReset = (RSTSRC & 0x08) ? 1 : 0;    // WDTRSF: the last reset came from the watchdog
+    if (readDS1307Burst(NV_SUPER, b, NV_SUPER_LEN) == I2C_OK &&
+        b[0] == NV_SUPER_MAGIC && b[3] == (U8)~(b[0] + b[1] + b[2]))
+    {
+        superWdtResets = b[1];
+        superLastMiss = b[2];
+    }
+    if (superWdtReset)
+    {
+        if (superWdtResets < 255) superWdtResets++;
+        superSave();
+    }
+    ET2 = 0;
+    wdtCredit = SUPER_FEED_MS;                  // First loop passes are covered
+    ET2 = 1;
+    PCA0CPL4 = 0xFF;                            // Longest timeout: 256  255 + (256 - PCA0L) PCA ticks
+    PCA0MD |= 0x60;                             // WDTE = 1 (watchdog on), WDLCK = 1 (locked on until reset)
+    PCA0CPH4 = 0x00;                            // First feed
+}
@@ -0,0 +1,100 @@
+// ================== timebase.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Hardware-timer timestamps, elapsed-time checks and short delays.
+// ----------------------------------------------------------
+// [1] Monotonic Clock (Timer2):
+//     -> clockMs counts Timer2 overflows (1 ms, Timer2_ISR in shadow_clock.h)
+//     -> clockNow(): ms since reset (wraps after 49.7 days)
+//     -> clockUs(): s since reset = clockMs  1000 + Timer2 count / 4 (wraps after
+//        71.6 min), consistent across an overflow the ISR has not serviced yet
+// [2] Elapsed Time (non-blocking):
+//     -> elapsed(since) / elapsedUs(since): unsigned difference, correct across a wrap
+//     -> Usage: if (elapsed(t0) >= 20) { t0 = clockNow(); ...step... }
+// [3] Delays:
+//     -> waitUs(): busy-waits on the free-running PCA0 counter (0.25 s ticks,
+//        up to 16383 s); an interrupt can only lengthen it, never shorten it
+//     -> waitMs(): busy-waits on clockUs()
+//     -> Unlike the vendor delay_us()/delay_ms() software loops, neither depends on
+//        compiler settings or on the time spent in interrupts
+// [4] Profiling:
+//     -> pcaNow() (0.25 s, 16-bit) for short sections, clockUs() for long ones
+// The IC SCL phases stay on cycle-counted DJNZ loops (I2C_LOW()/I2C_HIGH()): at
+// 1.1..5 s they are shorter than a timer poll.
+
+// ---------- [1] Monotonic Clock ----------
+#define TB_RELOAD       0xF060  // Timer2 reload: 65536 - 4000 (see Init_Device)
+#define TB_TICKS_MS     4000    // Timer2 ticks per ms (SYSCLK / 12 = 4 MHz)
+
+volatile U32 clockMs = 0;       // Timer2 ticks (ms) since reset, wraps after 49.7 days
+
+// clockNow(): clockMs read with the Timer2 interrupt masked (4-byte copy is not atomic).
+U32 clockNow(void)
+{
+    U32 t;
+    ET2 = 0;
+    t = clockMs;
+    ET2 = 1;
+    return t;
+}
+
+// clockUs(): s since reset.
+U32 clockUs(void)
+{
+    U8 hi, lo;
+    U16 t;
+    U32 ms;
+    ET2 = 0;
+    do {
+        hi = TMR2H;
+        lo = TMR2L;
+    } while (hi != TMR2H);                  // Low byte carried into the high byte between the reads
+    t = ((U16)hi << 8) | lo;
+    ms = clockMs;
+    if (TF2H && t < TB_RELOAD + TB_TICKS_MS / 2)
+        ms++;                               // Read after an overflow the ISR has not counted yet
+    ET2 = 1;
+    return ms * 1000UL + (U16)(t - TB_RELOAD) / 4;
+}
+
+// ---------- [2] Elapsed Time ----------
+// elapsed(): ms since a clockNow() timestamp.
+U32 elapsed(U32 since)
+{
+    return clockNow() - since;
+}
+
+// elapsedUs(): s since a clockUs() timestamp.
+U32 elapsedUs(U32 since)
+{
+    return clockUs() - since;
+}
+
+// ---------- [3] Delays + [4] Profiling ----------
+// pcaNow(): Captures the free-running PCA0 counter (reading PCA0L latches PCA0H).
+U16 pcaNow(void)
+{
+    U8 lo = PCA0L;
+    return ((U16)PCA0H << 8) | lo;
+}
+
+#ifndef SIM_HOST
+// waitUs(): Busy-waits at least `us` s (1..16383).
+void waitUs(U16 us)
+{
+    U16 t0 = pcaNow();
+    U16 ticks = us << 2;                    // 4 PCA ticks per s
+    while ((U16)(pcaNow() - t0) < ticks);
+}
+
+// waitMs(): Busy-waits at least `ms` ms.
+void waitMs(U16 ms)
+{
+    U32 t0 = clockUs();
+    while (elapsedUs(t0) < (U32)ms * 1000UL);
+}
+#else   // Host simulation: the simulated clock advances through the sim delays
+#define waitUs(us)  delay_us(us)
+#define waitMs(ms)  delay_ms(ms)
+#endif
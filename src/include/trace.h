@@ -0,0 +1,97 @@
+// ================== trace.h ==================
+// Project: Smart Irrigation System - Final Project
+// Target: C8051F380 Microcontroller
+// Overview:
+// Logic-analyzer trace port: a 4-bit code of what the firmware is running, on spare
+// port pins, at every main-loop task and ISR boundary.
+// ----------------------------------------------------------
+// [1] Build Switch:
+//     -> TRACE_MODE 0 (release): every hook compiles to nothing, P1.4..P1.7 stay unused
+//     -> TRACE_MODE 1: parallel code on P1.4..P1.7 (bit 0 = P1.4), one ANL + one ORL
+//        per hook (2  3 cycles); decode as a 4-bit bus
+//     -> TRACE_MODE 2: serial code, SPI mode 0, 4 bits MSB first: P1.4 = SCK,
+//        P1.5 = SDO, P1.6 = /CS (low while shifting), ~60 cycles per hook with
+//        interrupts masked, so an ISR code never splits a main-loop code
+// [2] Codes:
+//     -> 0..7 main-loop tasks, 8..13 ISRs (TR_ISR + ISR_xx of the interrupt map),
+//        14 boot, 15 free for a temporary hook
+//     -> The task codes are numbered in pass order: a pass runs TR_STAGE_FIRST ..
+//        TR_STAGE_LAST, then TR_IDLE. main() traces its stages in that order and the
+//        host simulation replays the same range (sim/i2c_sim.c traceLoop()), so a
+//        stage inserted here appears in both
+//     -> The code stays on the pins until the next hook: the time between two
+//        edges is the time spent in that task (TR_IDLE = pacing wait)
+// [3] Nesting:
+//     -> ISR_IN(id) saves traceNow and shows the ISR code, ISR_OUT(id) shows the
+//        saved code again, so an ISR (and Timer2 inside a low ISR) is a pulse on
+//        top of the code it interrupted
+//     -> Mode 1: between the ANL and the ORL the pins show the AND of the old and
+//        the new code for 3 cycles (62 ns), visible from 16 MHz sampling: set a glitch filter
+// [4] Host Simulation:
+//     -> SIM_HOST builds always trace: TRACE() hands the code to simTrace(), which
+//        writes it to the VCD file next to SDA/SCL and the servo PWM (sim/sim_vcd.c)
+
+// ---------- [1] Build Switch ----------
+#ifndef TRACE_MODE                      // (may be set on the command line)
+#define TRACE_MODE      0               // 0 = off, 1 = parallel code, 2 = serial code
+#endif
+
+// ---------- [2] Codes ----------
+#define TR_IDLE         0               // Pacing wait (rest of LOOP_MS)
+#define TR_TEMP         1               // LM75 batch pass
+#define TR_CLOCK        2               // Drift tracker, calendar, window edges
+#define TR_FLOW         3               // Flow meter, sector booking and probes
+#define TR_ADC          4               // Soil pipeline results, light/rain samples, sensor health
+#define TR_LOGIC        5               // Setup commit, runProject(), servo sweep
+#define TR_UI           6               // Screen refresh, touch read, menu navigation
+#define TR_SUPER        7               // Deadline supervisor, loop statistics
+#define TR_STAGE_FIRST  TR_TEMP         // Main-loop pass: TR_STAGE_FIRST .. TR_STAGE_LAST in order
+#define TR_STAGE_LAST   TR_SUPER
+#define TR_ISR          8               // + ISR_T2 .. ISR_OS (my_private_header.h [10])
+#define TR_BOOT         14              // main() up to the first loop pass
+#define TR_USER         15              // Free for a temporary hook
+
+volatile U8 traceNow = TR_IDLE;         // Code on the trace port
+
+// ---------- [1] + [3] Hooks ----------
+#define TRACE_PINS      0xF0            // P1.4..P1.7
+#define TRACE_SCK       0x10            // Mode 2: P1.4 clock
+#define TRACE_SDO       0x20            // Mode 2: P1.5 data
+#define TRACE_CS        0x40            // Mode 2: P1.6 frame (active low)
+
+#if defined(SIM_HOST)
+#define TRACE(c)        { traceNow = (c); simTrace(traceNow); }
+#elif TRACE_MODE == 1
+// ANL/ORL on the port latch: each is one read-modify-write instruction, so the
+// soil excitation bits on P1.2/P1.3 (written by Timer3_ISR) are never overwritten.
+// With a constant code both are immediate (ANL P1,#n / ORL P1,#n).
+#define TRACE(c)        { traceNow = (c); P1 &= (U8)(((c) << 4) | 0x0F); P1 |= (U8)((c) << 4); }
+#elif TRACE_MODE == 2
+#define TRACE(c)        { U8 _ea = EA, _b; EA = 0; traceNow = (c); P1 &= ~TRACE_CS; \
+                          for (_b = 0x08; _b; _b >>= 1) { \
+                              if (traceNow & _b) P1 |= TRACE_SDO; else P1 &= ~TRACE_SDO; \
+                              P1 |= TRACE_SCK; P1 &= ~TRACE_SCK; } \
+                          P1 |= TRACE_CS; EA = _ea; }
+#else
+#define TRACE(c)
+#endif
+
+#if TRACE_MODE && !defined(SIM_HOST)
+#define TRACE_SAVE      U8 _trSave = traceNow;      // ISR entry: code to show again on exit (declaration)
+#define TRACE_RESTORE   TRACE(_trSave)
+
+// traceStart(): Trace pins push-pull, skipped by the crossbar, idle level (first call in main()).
+void traceStart(void)
+{
+    P1MDOUT |= TRACE_PINS;
+    P1SKIP |= TRACE_PINS;
+    P1 &= ~TRACE_PINS;                  // Code 0 (mode 2: SCK and SDO low, /CS high)
+#if TRACE_MODE == 2
+    P1 |= TRACE_CS;
+#endif
+}
+#else
+#define TRACE_SAVE
+#define TRACE_RESTORE
+#define traceStart()
+#endif
@@ -3,8 +3,9 @@
 // Target:  C8051F380 Microcontroller
 // Purpose:
 // Initializes all hardware peripherals before entering main().
-// -> Disables Watchdog Timer
-// -> Sets up PCA for PWM control (Servo on P0.0)
+// -> Forces the relay (pump) OFF first, on every reset path (power-on, watchdog, pin)
+// -> Disables Watchdog Timer during init (supervisor.h enables it again before the main loop)
+// -> Sets up PCA for PWM control (Servo on P0.0; more channels in servo.h)
 // -> PCA operates at SYSCLK / 12 = 4MHz -> 1 tick = 0.25s
 // -> Configures Crossbar and SPI routing
 // -> SPI can operate up to SYSCLK / 2 -> limited to ~12.5MHz max (hardware limit)
@@ -12,8 +13,14 @@
 // -> IC standard-mode supports up to 400kHz = **400,000 bits per second**
 // -> This is the bit-rate (not samples!) for serial communication on SDA/SCL
 // -> Sets Relay control pin (P0.2) as Push-Pull output
+// -> Routes the LM75 O.S. comparator output (P0.7) to /INT0
 // -> Prepares ADC input pins (P2.0P2.2) for analog sensors
 // -> ADC0 is a 10-bit SAR ADC, supports up to 500kSPS (Samples Per Second)
+// -> Timer3 (10 ms) clocks the soil pipeline: probe excitation on P1.2/P1.3, settle,
+//    conversion; ADC0 window compare flags threshold crossings (my_private_header.h)
+// -> Timer2 (1 ms) interrupt drives the shadow clock (shadow_clock.h)
+// -> Timer0 counts flow-sensor pulses on T0 (P0.1) in hardware (flow.h)
+// -> Interrupt priorities: Timer2 high, all others low (map in my_private_header.h)
 // -> ADC = Analog-to-Digital Converter (used for Rain, Soil, Light sensors)
 // -> Enables Internal Oscillator and Clock Multiplier (SYSCLK = 48MHz)
 #include "compiler_defs.h"
@@ -21,6 +28,10 @@
 
 void Init_Device(void)
 {
+    // 0) Pump OFF before anything else: after a reset P0.2 is open-drain with its
+    //    latch HIGH (weak pull-up -> relay driver may be biased). LOW is valid in open-drain mode.
+    P0 &= ~0x04;
+
     // 1) Disable Watchdog Timer and configure PCA clock source
     PCA0MD &= ~0x40;  // Clear WDTE bit -> disables Watchdog Timer (prevents unwanted resets)
     PCA0MD = 0x00;    // Sets PCA clock source to SYSCLK / 12 ->
@@ -34,17 +45,20 @@ void Init_Device(void)
     // -> Used to generate accurate PWM pulses for servo control
 	
     // 3) Crossbar Configuration
+    P0SKIP |= 0x04;      // Crossbar skips P0.2: the relay pin stays GPIO whatever gets routed (servo.h)
     XBR1 = 0x41;         // Enable Crossbar (bit 0 = 1) and route PCA Channel 0 (CEX0) to P0.0 (bit 6 = 0)
+                         // -> More servo channels (CEX1..CEX3) are added by servoStart() (servo.h)
                          // -> Connects PWM output from PCA (used for servo) to the physical pin P0.0
     P0MDOUT |= 0x01;     // Set P0.0 as Push-Pull output (for strong HIGH and LOW levels)
                          // -> Required for generating a clean, sharp PWM signal for servo control
     // 4) IC Configuration (for LM75 + DS1307 via P1.0 = SCL, P1.1 = SDA)
-    // Set P1.0 (SCL) as Push-Pull output for fast clock edges (Master drives SCL directly)
-    P1MDOUT |= 0x01;
+    // Set P1.0 (SCL) as Open-Drain so the master can read SCL back:
+    // a slave stretching the clock (or a stuck bus) is detected instead of ignored
+    P1MDOUT &= ~0x01;
     // Set P1.1 (SDA) as Open-Drain for proper bidirectional communication (IC standard)
     P1MDOUT &= ~0x02;
     
-    P1 |= 0x02;
+    P1 |= 0x03;        // Release SCL and SDA (pull-ups hold the idle bus HIGH)
 		
     // 5) Relay Output Setup (Relay control via P0.2)
     P0MDOUT |= 0x04;         // Set P0.2 as Push-Pull output (strong 0/1 control)
@@ -77,4 +91,56 @@ void Init_Device(void)
 
     // 8) SPI  Serial Peripheral Interface Configuration is performed in initSysSpi() (called later in main)
     // Example (not here): SPI0CKR = 2 -> SPI Clock = SYSCLK / [2  (2 + 1)] = 8MHz
+
+    // 9) LM75 O.S. Input (P0.7 -> /INT0)
+    P0MDOUT &= ~0x80;  // P0.7 Open-Drain: O.S. is an open-drain output on the LM75 side (pull-up on the module)
+    P0 |= 0x80;        // Latch HIGH -> pin is released and can be read as an input
+    P0SKIP |= 0x80;    // Crossbar skips P0.7 so no peripheral is ever routed onto the alarm line
+    IT01CF = (IT01CF & 0xF0) | 0x07; // /INT0 source = P0.7, IN0PL = 0 (active-low, matches O.S. polarity)
+    IT0 = 1;           // Edge-triggered: one interrupt per threshold crossing, not per loop
+    IE0 = 0;           // Clear any edge latched while the pin was being configured
+    EX0 = 1;           // Enable /INT0 interrupt (LM75_OS_ISR)
+
+    // 10) Soil Pipeline: Timer3 -> ADC0 start-of-conversion, window compare on P2.1
+    TMR3CN = 0x00;     // Stop Timer3, 16-bit auto-reload, clock = SYSCLK / 12 (T3XCLK = 0, CKCON.T3ML = 0)
+    TMR3RLL = 0xC0;    // Reload = 65536 - 40000 = 0x63C0 -> 40000  0.25 s = 10 ms per conversion
+    TMR3RLH = 0x63;
+    TMR3L = 0xC0;      // Start the first period from the reload value
+    TMR3H = 0x63;
+    AMX0P = 0x01;      // Multiplexer parked on the soil channel (P2.1) between software reads
+    ADC0CN = 0x80;     // ADEN = 1, AD0CM = 000: the pipeline sets AD0CM = 101 (Timer3 overflow
+                       // starts a conversion) only for the overflow that ends a settle window
+    TMR3CN |= 0x04;    // TR3 = 1 -> start Timer3 (interrupt enabled by soilStart())
+                       // -> Window interrupt (EIE1.EWADC0) is enabled by setSoilWindow() once the threshold is known
+
+    // 11) Timebase: Timer2 -> 1 ms interrupt (shadow clock, drift measurement)
+    TMR2CN = 0x00;     // Stop Timer2, 16-bit auto-reload, clock = SYSCLK / 12 (T2XCLK = 0, CKCON.T2ML = 0)
+    TMR2RLL = 0x60;    // Reload = 65536 - 4000 = 0xF060 -> 4000  0.25 s = 1 ms per overflow
+    TMR2RLH = 0xF0;
+    TMR2L = 0x60;      // Start the first period from the reload value
+    TMR2H = 0xF0;
+    ET2 = 1;           // Enable Timer2 interrupt (Timer2_ISR)
+    TR2 = 1;           // Start Timer2
+
+    // 12) Flow Meter: Timer0 counts hall-sensor pulses on T0
+    P0MDOUT &= ~0x02;  // P0.1 Open-Drain input (sensor output is open-collector, pull-up on the module)
+    P0 |= 0x02;        // Latch HIGH -> pin is released and can be read as an input
+    XBR1 |= 0x10;      // T0E = 1 -> T0 goes to the next free crossbar pin after CEX0 = P0.1
+                       // -> With more servo channels T0 moves up (pin table in servo.h; those
+                       //    pins are open-drain with the latch HIGH after reset)
+    TMOD = (TMOD & 0xF0) | 0x05;  // Timer0: C/T0 = 1 (counts T0 falling edges), mode 1 (16-bit), GATE0 = 0
+    TL0 = 0;
+    TH0 = 0;
+    ET0 = 0;           // No interrupt: flowPoll() reads the count once per loop
+    TR0 = 1;           // Start counting
+
+    // 13) Soil Probe Excitation: P1.2 (supply) / P1.3 (return), off between samples
+    P1MDOUT |= 0x0C;   // P1.2, P1.3 Push-Pull: the probe is powered straight from the pins
+    P1 &= ~0x0C;       // Both LOW -> probe unpowered
+    P1SKIP |= 0x0C;    // Crossbar skips P1.2/P1.3 (GPIO only)
+
+    // 14) Interrupt Priorities: one level per register bank (interrupt map in my_private_header.h)
+    IP = 0x20;         // PT2 = 1: Timer2 high (timebase + watchdog feed, register bank 2)
+    EIP1 = 0x00;       // PCA0, ADC0 window / end of conversion, Timer3: low (bank 1, with /INT0)
+    EA = 1;            // Global interrupt enable
 }
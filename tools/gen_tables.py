@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Generates src/include/lut_tables.h: CODE-space lookup tables for the firmware's
+pure conversion functions, from the scales and calibration in the config headers.
+
+    python3 tools/gen_tables.py           write lut_tables.h, print the trade-off
+    python3 tools/gen_tables.py --check   exit 1 if lut_tables.h is out of date (CI)
+
+Run it before every build (uVision: Options -> User -> Before Build) or at least
+after changing ADC_PCT_NUM/DEN (my_private_header.h) or SERVO_US_0/180
+(site_config.h). Whether a function uses its table or its arithmetic is chosen by
+the LUT_* switches in my_private_header.h; the generated header holds all tables,
+each behind its switch, and the size/speed trade-off in its banner.
+"""
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+INC = os.path.join(ROOT, "src", "include")
+OUT = os.path.join(INC, "lut_tables.h")
+
+
+def defines(name):
+    """#define NAME value pairs of a header (numeric values only)."""
+    text = open(os.path.join(INC, name), encoding="latin-1").read()
+    out = {}
+    for m in re.finditer(r"^\s*#define\s+(\w+)\s+\(?(-?\d+)\)?(?:UL|L|U)?\b", text, re.M):
+        out[m.group(1)] = int(m.group(2))
+    return out
+
+
+def servo_lut(us0, us180, deg_max):
+    """Same carried-remainder walk as servoLutBuild() (servo.h), bit for bit."""
+    c = (-(us0 * 4)) & 0xFFFF
+    span = (us180 - us0) * 4
+    mag = abs(span)
+    q, r = mag // deg_max, mag % deg_max
+    acc, t = 0, []
+    for _ in range(deg_max + 1):
+        t.append(c)
+        inc = q
+        acc += r
+        if acc >= deg_max:
+            acc -= deg_max
+            inc += 1
+        c = (c - inc) & 0xFFFF if span > 0 else (c + inc) & 0xFFFF
+    return t
+
+
+def rows(values, per_line, fmt):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt % v for v in values[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+# Per-call cost estimates on the CIP-51 (SYSCLK cycles), table vs arithmetic. The
+# table side is an index add plus MOVC; the arithmetic side follows the code C51
+# emits for the expression (16-bit multiply and divide through ?C?IMUL/?C?UIDIV).
+# Estimates only: measure on the target with pcaNow() around a loop of calls.
+COST = {
+    "adc": (12, 260),       # raw * NUM / DEN with a 16-bit divide
+    "bcd2dec": (6, 12),     # SWAP/ANL, MUL AB, ADD
+    "dec2bcd": (6, 20),     # two DIV AB
+    "servo": (15, 35),      # per degree entry in servoLutBuild() (boot / calibration only)
+}
+
+
+def generate():
+    mph = defines("my_private_header.h")
+    site = defines("site_config.h")
+    servo = defines("servo.h")
+    num, den = mph["ADC_PCT_NUM"], mph["ADC_PCT_DEN"]
+    us0, us180 = site["SERVO_US_0"], site["SERVO_US_180"]
+    deg_max = servo["SERVO_DEG_MAX"]
+
+    adc = [raw * num // den for raw in range(1024)]
+    if max(adc) > 255:
+        sys.exit("gen_tables: ADC_PCT_NUM/DEN give values above 255 (U8 table)")
+    b2d = [((v >> 4) * 10 + (v & 0x0F)) & 0xFF for v in range(256)]
+    d2b = [(((v // 10) << 4) | (v % 10)) & 0xFF for v in range(256)]
+    lut = servo_lut(us0, us180, deg_max)
+
+    report = [
+        ("LUT_ADC_PCT", "adcPctTable", len(adc), "ADC_PCT(): count -> %", COST["adc"], "per sample"),
+        ("LUT_BCD", "bcdDecTable", len(b2d), "bcdToDec()", COST["bcd2dec"], "per RTC field"),
+        ("LUT_BCD", "decBcdTable", len(d2b), "decToBcd()", COST["dec2bcd"], "per RTC field"),
+        ("LUT_SERVO", "servoLutDefault", 2 * len(lut), "servoLutBuild(), default cal.", COST["servo"], "x181, boot only"),
+    ]
+
+    h = []
+    h.append("// ================== lut_tables.h ==================")
+    h.append("// Project: Smart Irrigation System - Final Project")
+    h.append("// Target: C8051F380 Microcontroller")
+    h.append("// Overview:")
+    h.append("// GENERATED by tools/gen_tables.py - do not edit. Lookup tables in CODE space for")
+    h.append("// pure conversion functions, from the scales and calibration below.")
+    h.append("// ----------------------------------------------------------")
+    h.append("// Inputs:")
+    h.append("//     -> ADC_PCT_NUM / ADC_PCT_DEN = %d / %d (my_private_header.h)" % (num, den))
+    h.append("//     -> SERVO_US_0 / SERVO_US_180 = %d / %d us (site_config.h), SERVO_DEG_MAX = %d" % (us0, us180, deg_max))
+    h.append("// Trade-off (CODE bytes; CIP-51 cycles per call, table vs arithmetic, estimates):")
+    h.append("//     Switch       Table            Bytes  Cycles     Used by")
+    for sw, name, size, user, (tc, ac), note in report:
+        h.append("//     %-12s %-16s %5d  %3d vs %-3d  %s, %s" % (sw, name, size, tc, ac, user, note))
+    h.append("// Switches in my_private_header.h (1 = table, 0 = arithmetic); a table is only")
+    h.append("// linked in when its switch is on.")
+    h.append("")
+    h.append("// ---------- Generation Inputs (checked against the headers) ----------")
+    h.append("#define LUT_GEN_ADC_NUM     %d" % num)
+    h.append("#define LUT_GEN_ADC_DEN     %d" % den)
+    h.append("#define LUT_GEN_SERVO_US_0  %d" % us0)
+    h.append("#define LUT_GEN_SERVO_US_180 %d" % us180)
+    h.append("#if LUT_GEN_ADC_NUM != ADC_PCT_NUM || LUT_GEN_ADC_DEN != ADC_PCT_DEN")
+    h.append('#error "lut_tables.h is out of date: run tools/gen_tables.py"')
+    h.append("#endif")
+    h.append("")
+    h.append("#if LUT_ADC_PCT")
+    h.append("// ADC count (0..1023) -> %% = count * %d / %d" % (num, den))
+    h.append("U8 code adcPctTable[1024] = {")
+    h.append(rows(adc, 16, "%3d"))
+    h.append("};")
+    h.append("#endif")
+    h.append("")
+    h.append("#if LUT_BCD")
+    h.append("// BCD byte -> decimal (every byte, same result as the arithmetic for invalid BCD)")
+    h.append("U8 code bcdDecTable[256] = {")
+    h.append(rows(b2d, 16, "%3d"))
+    h.append("};")
+    h.append("// Decimal -> BCD byte (every byte, same result as the arithmetic above 99)")
+    h.append("U8 code decBcdTable[256] = {")
+    h.append(rows(d2b, 16, "0x%02X"))
+    h.append("};")
+    h.append("#endif")
+    h.append("")
+    h.append("#if LUT_SERVO")
+    h.append("// PCA compare value per degree for the default calibration (%d..%d us)" % (us0, us180))
+    h.append("U16 code servoLutDefault[%d] = {" % (deg_max + 1))
+    h.append(rows(lut, 10, "0x%04X"))
+    h.append("};")
+    h.append("#endif")
+    text = ("\n".join(h) + "\n").replace("\n", "\r\n")     # CRLF like the other sources
+    return text, report
+
+
+def main():
+    text, report = generate()
+    old = open(OUT, "rb").read().decode("latin-1") if os.path.exists(OUT) else None
+    if "--check" in sys.argv[1:]:
+        if old != text:
+            print("lut_tables.h is out of date: run tools/gen_tables.py")
+            return 1
+        print("lut_tables.h is up to date")
+        return 0
+    if old != text:
+        open(OUT, "wb").write(text.encode("latin-1"))
+    print("%-12s %-16s %6s %8s %8s" % ("switch", "table", "bytes", "tbl cy", "math cy"))
+    for sw, name, size, _user, (tc, ac), _note in report:
+        print("%-12s %-16s %6d %8d %8d" % (sw, name, size, tc, ac))
+    print("wrote" if old != text else "unchanged", os.path.relpath(OUT, ROOT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())